@@ -3,14 +3,31 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <iosfwd>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FA_X86_SIMD
+#include <immintrin.h>
+#endif
+
 namespace fa {
 /**
  * Operateur permettant de savoir si 2 transitions sont similaires
@@ -52,7 +69,546 @@ bool operator==(std::set<int> set_1, std::set<int> set_2) {
   return true;
 }
 
-Automaton::Automaton() {}
+// Fonction recevant les statistiques des opérations
+static StatsCallback stats_callback;
+
+/**
+ * Set the function called at the end of each instrumented operation
+ *
+ * The static methods building automata report their statistics, which
+ * include those of the operations they call. The statistics are only
+ * collected when the library is compiled with FA_STATS defined (CMake
+ * option FA_ENABLE_STATS); otherwise the callback is never called and
+ * the instrumentation costs nothing. The callback must not be changed
+ * while operations run on other threads.
+ */
+void Automaton::setStatsCallback(StatsCallback callback) {
+  stats_callback = std::move(callback);
+}
+
+#ifdef FA_STATS
+/**
+ * Statistiques de l'opération en cours sur le thread, de sa création à sa
+ * destruction. Une opération imbriquée ajoute ses statistiques à l'englobante.
+ */
+class StatsScope {
+public:
+  explicit StatsScope(const char* operation)
+      : operation(operation), stats(), parent(current),
+        start(std::chrono::steady_clock::now()) {
+    current = this;
+  }
+
+  ~StatsScope() {
+    stats.seconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    current = parent;
+    if (parent != nullptr) {
+      parent->stats.states_created += stats.states_created;
+      parent->stats.transitions_created += stats.transitions_created;
+      parent->stats.macrostates_explored += stats.macrostates_explored;
+      parent->stats.refinement_rounds += stats.refinement_rounds;
+      parent->stats.hash_collisions += stats.hash_collisions;
+      parent->stats.bytes_allocated += stats.bytes_allocated;
+    }
+    if (stats_callback) {
+      stats_callback(operation, stats);
+    }
+  }
+
+  /**
+  * Permet d'obtenir les statistiques de l'opération en cours, ou nullptr
+  */
+  static OperationStats* current_stats() {
+    return current == nullptr ? nullptr : &current->stats;
+  }
+
+private:
+  static thread_local StatsScope* current;
+  const char* operation;
+  OperationStats stats;
+  StatsScope* parent;
+  std::chrono::steady_clock::time_point start;
+};
+
+thread_local StatsScope* StatsScope::current = nullptr;
+
+/**
+ * Permet de compter les états et les transitions d'un automate construit
+ */
+static void count_result(const Automaton& automaton) {
+  OperationStats* stats = StatsScope::current_stats();
+  if (stats == nullptr) {
+    return;
+  }
+  stats->states_created += automaton.countStates();
+  stats->transitions_created += automaton.countTransitions();
+  stats->bytes_allocated +=
+      automaton.set_of_transitions.capacity() * sizeof(struct Transition) +
+      automaton.countStates() + automaton.countSymbols() * 4 * sizeof(void*);
+}
+
+#define FA_STATS_SCOPE(operation) StatsScope stats_scope(operation)
+#define FA_STATS_ADD(field, value)                                           \
+  do {                                                                       \
+    if (OperationStats* stats = StatsScope::current_stats()) {               \
+      stats->field += (value);                                               \
+    }                                                                        \
+  } while (0)
+#define FA_STATS_RESULT(automaton) count_result(automaton)
+#else
+#define FA_STATS_SCOPE(operation)
+#define FA_STATS_ADD(field, value)
+#define FA_STATS_RESULT(automaton)
+#endif
+
+/**
+ * Build an empty table, using the default memory resource
+ */
+StateTable::StateTable() : count(0), sparse(false) {}
+
+/**
+ * Build an empty table, using the given memory resource
+ */
+StateTable::StateTable(std::pmr::memory_resource* resource)
+    : flags(resource), count(0), sparse(false), indices(resource),
+      free_indices(resource) {}
+
+/**
+ * Permet d'obtenir l'indice d'un état, ou flags.size() s'il est absent
+ */
+std::size_t StateTable::find_index(int state) const {
+  if (sparse) {
+    auto it = indices.find(state);
+    return (it == indices.end()) ? flags.size() : it->second;
+  }
+  if (state < 0 || static_cast<std::size_t>(state) >= flags.size() ||
+      !(flags[state] & Present)) {
+    return flags.size();
+  }
+  return state;
+}
+
+/**
+ * Permet de passer en mode creux, quand les numéros d'états sont trop grands
+ */
+void StateTable::make_sparse() {
+  // Les indices restent les numéros actuels, les trous deviennent libres
+  for (std::size_t i = 0; i < flags.size(); i++) {
+    if (flags[i] & Present) {
+      indices[i] = i;
+    } else {
+      free_indices.push_back(i);
+    }
+  }
+  sparse = true;
+}
+
+/**
+ * Count the number of states
+ */
+std::size_t StateTable::size() const { return count; }
+
+/**
+ * Tell if there is no state
+ */
+bool StateTable::empty() const { return count == 0; }
+
+/**
+ * Tell if the state is present
+ */
+bool StateTable::contains(int state) const {
+  return find_index(state) != flags.size();
+}
+
+/**
+ * Add a state, neither initial nor final
+ *
+ * Returns true if the state was effectively added.
+ */
+bool StateTable::insert(int state) {
+  if (contains(state)) {
+    return false;
+  }
+
+  // Un numéro bien plus grand que le nombre d'états gâcherait de la place
+  if (!sparse && static_cast<std::size_t>(state) >= flags.size() &&
+      static_cast<std::size_t>(state) > 2 * count + 64) {
+    make_sparse();
+  }
+
+  if (sparse) {
+    std::size_t index = flags.size();
+    if (!free_indices.empty()) {
+      index = free_indices.back();
+      free_indices.pop_back();
+    } else {
+      flags.push_back(0);
+    }
+    indices[state] = index;
+    flags[index] = Present;
+  } else {
+    if (static_cast<std::size_t>(state) >= flags.size()) {
+      flags.resize(state + 1, 0);
+    }
+    flags[state] = Present;
+  }
+  count++;
+  return true;
+}
+
+/**
+ * Remove a state
+ *
+ * Returns true if the state was effectively removed.
+ */
+bool StateTable::erase(int state) {
+  std::size_t index = find_index(state);
+  if (index == flags.size()) {
+    return false;
+  }
+  flags[index] = 0;
+  count--;
+
+  if (count == 0) {
+    clear();
+  } else if (sparse) {
+    indices.erase(state);
+    free_indices.push_back(index);
+  } else {
+    while (!flags.empty() && flags.back() == 0) {
+      flags.pop_back();
+    }
+  }
+  return true;
+}
+
+/**
+ * Remove all the states
+ */
+void StateTable::clear() {
+  flags.clear();
+  indices.clear();
+  free_indices.clear();
+  count = 0;
+  sparse = false;
+}
+
+/**
+ * Tell if the state is present and initial
+ */
+bool StateTable::isInitial(int state) const {
+  std::size_t index = find_index(state);
+  return index != flags.size() && (flags[index] & Initial);
+}
+
+/**
+ * Tell if the state is present and final
+ */
+bool StateTable::isFinal(int state) const {
+  std::size_t index = find_index(state);
+  return index != flags.size() && (flags[index] & Final);
+}
+
+/**
+ * Set the state initial, if present
+ */
+void StateTable::setInitial(int state) {
+  std::size_t index = find_index(state);
+  if (index != flags.size()) {
+    flags[index] |= Initial;
+  }
+}
+
+/**
+ * Set the state final, if present
+ */
+void StateTable::setFinal(int state) {
+  std::size_t index = find_index(state);
+  if (index != flags.size()) {
+    flags[index] |= Final;
+  }
+}
+
+/**
+ * Tell if the states are numbered from 0 to size() - 1
+ */
+bool StateTable::isCompact() const {
+  if (count == 0) {
+    return true;
+  }
+  if (sparse) {
+    return indices.begin()->first == 0 &&
+           indices.rbegin()->first == static_cast<int>(count) - 1;
+  }
+  // En mode dense, flags s'arrête au dernier état présent
+  return flags.size() == count;
+}
+
+StateTable::const_iterator StateTable::begin() const {
+  const_iterator it;
+  it.table = this;
+  it.index = 0;
+  it.position = indices.begin();
+  while (!sparse && it.index < flags.size() && !(flags[it.index] & Present)) {
+    it.index++;
+  }
+  return it;
+}
+
+StateTable::const_iterator StateTable::end() const {
+  const_iterator it;
+  it.table = this;
+  it.index = flags.size();
+  it.position = indices.end();
+  return it;
+}
+
+StateTable::Entry StateTable::const_iterator::operator*() const {
+  int state = table->sparse ? position->first : index;
+  unsigned char state_flags =
+      table->flags[table->sparse ? position->second : index];
+  return {state, {(state_flags & Initial) != 0, (state_flags & Final) != 0}};
+}
+
+StateTable::const_iterator& StateTable::const_iterator::operator++() {
+  if (table->sparse) {
+    ++position;
+  } else {
+    do {
+      index++;
+    } while (index < table->flags.size() && !(table->flags[index] & Present));
+  }
+  return *this;
+}
+
+bool StateTable::const_iterator::operator==(
+    const const_iterator& other) const {
+  return table->sparse ? position == other.position : index == other.index;
+}
+
+bool StateTable::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return !(*this == other);
+}
+
+/**
+ * Permet d'obtenir l'indice du bit non nul le plus faible d'un mot non nul
+ */
+static std::size_t lowest_bit(std::uint64_t word) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(word);
+#else
+  std::size_t index = 0;
+  while (!(word & 1)) {
+    word >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+/**
+ * Build an empty alphabet
+ */
+Alphabet::Alphabet() : bits(), count(0) {}
+
+/**
+ * Permet d'obtenir le rang d'un symbole dans l'ordre des char
+ */
+std::size_t Alphabet::position_of(char symbol) {
+  // Les char signés commencent à -128
+  return std::is_signed<char>::value ? static_cast<unsigned char>(symbol) ^ 0x80
+                                     : static_cast<unsigned char>(symbol);
+}
+
+/**
+ * Permet d'obtenir le rang du premier symbole présent à partir d'un rang
+ */
+std::size_t Alphabet::next_position(std::size_t position) const {
+  while (position < 256) {
+    std::uint64_t word = bits[position / 64] >> (position % 64);
+    if (word != 0) {
+      return position + lowest_bit(word);
+    }
+    position = (position / 64 + 1) * 64;
+  }
+  return 256;
+}
+
+/**
+ * Add a symbol, returns true if it was not present
+ */
+bool Alphabet::insert(char symbol) {
+  std::size_t position = position_of(symbol);
+  std::uint64_t mask = std::uint64_t(1) << (position % 64);
+  if (bits[position / 64] & mask) {
+    return false;
+  }
+  bits[position / 64] |= mask;
+  count++;
+  return true;
+}
+
+/**
+ * Remove a symbol, returns true if it was present
+ */
+bool Alphabet::erase(char symbol) {
+  std::size_t position = position_of(symbol);
+  std::uint64_t mask = std::uint64_t(1) << (position % 64);
+  if (!(bits[position / 64] & mask)) {
+    return false;
+  }
+  bits[position / 64] &= ~mask;
+  count--;
+  return true;
+}
+
+/**
+ * Tell if a symbol is present
+ */
+bool Alphabet::contains(char symbol) const {
+  std::size_t position = position_of(symbol);
+  return (bits[position / 64] >> (position % 64)) & 1;
+}
+
+/**
+ * Remove all the symbols
+ */
+void Alphabet::clear() {
+  for (auto& word : bits) {
+    word = 0;
+  }
+  count = 0;
+}
+
+std::size_t Alphabet::size() const { return count; }
+
+bool Alphabet::empty() const { return count == 0; }
+
+Alphabet::const_iterator Alphabet::begin() const {
+  const_iterator it;
+  it.alphabet = this;
+  it.position = next_position(0);
+  return it;
+}
+
+Alphabet::const_iterator Alphabet::end() const {
+  const_iterator it;
+  it.alphabet = this;
+  it.position = 256;
+  return it;
+}
+
+bool Alphabet::operator==(const Alphabet& other) const {
+  return std::equal(std::begin(bits), std::end(bits), std::begin(other.bits));
+}
+
+bool Alphabet::operator!=(const Alphabet& other) const {
+  return !(*this == other);
+}
+
+char Alphabet::const_iterator::operator*() const {
+  return static_cast<char>(std::is_signed<char>::value ? position ^ 0x80 : position);
+}
+
+Alphabet::const_iterator& Alphabet::const_iterator::operator++() {
+  position = alphabet->next_position(position + 1);
+  return *this;
+}
+
+bool Alphabet::const_iterator::operator==(const const_iterator& other) const {
+  return position == other.position;
+}
+
+bool Alphabet::const_iterator::operator!=(const const_iterator& other) const {
+  return !(*this == other);
+}
+
+Automaton::Automaton()
+    : generation(0), properties(nullptr), matcher(nullptr) {}
+
+/**
+ * Build an empty automaton whose memory comes from the given resource
+ *
+ * The automata created by the static methods use the memory resource of
+ * their (first) argument, so that a whole transformation can run in an
+ * arena such as std::pmr::monotonic_buffer_resource. Like for the
+ * standard containers, a copy-constructed automaton uses the default
+ * resource, while an assigned automaton keeps its own resource.
+ */
+Automaton::Automaton(std::pmr::memory_resource* resource)
+    : set_of_states(resource), set_of_transitions(resource), generation(0),
+      properties(nullptr), matcher(nullptr) {}
+
+/**
+ * Get the memory resource of the automaton
+ */
+std::pmr::memory_resource* Automaton::getResource() const {
+  return set_of_transitions.get_allocator().resource();
+}
+
+/**
+ * Get the generation of the automaton
+ *
+ * The generation is incremented by every modifying method and by
+ * invalidate. The structural properties (determinism, completeness, ...)
+ * and the compiled form used by match are computed once and then cached
+ * until the generation changes, so that a repeated query costs O(1).
+ * The cache is published atomically, so that const queries may run
+ * concurrently on the same automaton.
+ */
+std::size_t Automaton::getGeneration() const { return generation; }
+
+/**
+ * Invalidate the cached properties after a direct change of the members
+ *
+ * The public members may be modified without the methods, for instance
+ * to add transitions in bulk; invalidate must then be called before the
+ * next query, otherwise the cached answers are those of the old content.
+ */
+void Automaton::invalidate() { generation++; }
+
+/**
+ * Permet d'obtenir les propriétés de l'automate, calculées si besoin
+ */
+std::shared_ptr<const Automaton::Properties> Automaton::get_properties() const {
+  // La génération fait foi : les modifications directes appellent invalidate
+  std::shared_ptr<const Properties> cached = std::atomic_load(&properties);
+  if (cached != nullptr && cached->generation == generation) {
+    return cached;
+  }
+
+  auto computed = std::make_shared<Properties>();
+  FrozenAutomaton frozen = freeze();
+  computed->generation = generation;
+  computed->deterministic = frozen.isDeterministic();
+  computed->complete = frozen.isComplete();
+  computed->language_empty = frozen.isLanguageEmpty();
+  computed->trimmed = frozen.isTrimmed();
+  computed->has_epsilon = false;
+  for (auto& t : set_of_transitions) {
+    if (t.symbol == fa::Epsilon) {
+      computed->has_epsilon = true;
+      break;
+    }
+  }
+  computed->nb_final_states = 0;
+  for (const auto& s : set_of_states) {
+    if (s.second.isInitial) {
+      computed->initial_states.push_back(s.first);
+    }
+    if (s.second.isFinal) {
+      computed->nb_final_states++;
+    }
+  }
+
+  // Deux threads peuvent calculer les mêmes propriétés, le dernier les publie
+  std::shared_ptr<const Properties> published = computed;
+  std::atomic_store(&properties, published);
+  return published;
+}
 
 /**
  * Tell if an automaton is valid .
@@ -67,6 +623,16 @@ bool Automaton::isValid() const {
   return true;
 }
 
+/**
+ * Tell if a symbol may be added to an automaton
+ *
+ * Every byte except Epsilon is a valid symbol, including whitespace,
+ * control characters and the bytes of UTF-8 sequences.
+ */
+bool Automaton::isValidSymbol(char symbol) {
+  return symbol != fa::Epsilon;
+}
+
 /**
  * Add a symbol to the automaton
  *
@@ -74,9 +640,9 @@ bool Automaton::isValid() const {
  * Returns true if the symbol was effectively added
  */
 bool Automaton::addSymbol(char symbol) {
-  if (isgraph(symbol) && hasSymbol(symbol) == false) {
-    alphabet.insert(symbol);
-    return true;
+  generation++;
+  if (isValidSymbol(symbol)) {
+    return alphabet.insert(symbol);
   }
   return false;
 }
@@ -87,8 +653,8 @@ bool Automaton::addSymbol(char symbol) {
  * Returns true if the symbol was effectively removed
  */
 bool Automaton::removeSymbol(char symbol) {
-  if (alphabet.find(symbol) != alphabet.end()) {
-    alphabet.erase(symbol);
+  generation++;
+  if (alphabet.erase(symbol)) {
     // Supprime les transitions contenant le symbole
     for (auto& t : set_of_transitions) {
       if (t.symbol == symbol) {
@@ -104,10 +670,7 @@ bool Automaton::removeSymbol(char symbol) {
  * Tell if the symbol is present in the automaton
  */
 bool Automaton::hasSymbol(char symbol) const {
-  if (alphabet.find(symbol) != alphabet.end()) {
-    return true;
-  }
-  return false;
+  return alphabet.contains(symbol);
 }
 
 /**
@@ -122,12 +685,11 @@ std::size_t Automaton::countSymbols() const { return alphabet.size(); }
  * Returns true if the state was effectively added and false otherwise.
  */
 bool Automaton::addState(int state) {
-  if (state < 0 || hasState(state)) {
+  generation++;
+  if (state < 0) {
     return false;
   }
-  struct State s = {false, false};
-  set_of_states.insert({state, s});
-  return true;
+  return set_of_states.insert(state);
 }
 
 /**
@@ -137,9 +699,9 @@ bool Automaton::addState(int state) {
  * Returns true if the state was effectively removed and false otherwise.
  */
 bool Automaton::removeState(int state) {
-  if (hasState(state)) {
-    // Supprime l'état
-    set_of_states.erase(state);
+  generation++;
+  // Supprime l'état
+  if (set_of_states.erase(state)) {
 
     std::vector<struct Transition> transition_to_delete;
 
@@ -166,10 +728,7 @@ bool Automaton::removeState(int state) {
  * Tell if the state is present in the automaton.
  */
 bool Automaton::hasState(int state) const {
-  if (set_of_states.find(state) != set_of_states.end()) {
-    return true;
-  }
-  return false;
+  return set_of_states.contains(state);
 }
 
 /**
@@ -181,46 +740,30 @@ std::size_t Automaton::countStates() const { return set_of_states.size(); }
  * Set the state initial.
  */
 void Automaton::setStateInitial(int state) {
-  if (hasState(state)) {
-    auto it = set_of_states.find(state);
-    it->second.isInitial = true;
-  }
+  generation++;
+  set_of_states.setInitial(state);
 }
 
 /**
  * Tell if the state is initial.
  */
 bool Automaton::isStateInitial(int state) const {
-  if (hasState(state)) {
-    auto it = set_of_states.find(state);
-    if (it->second.isInitial == true) {
-      return true;
-    }
-  }
-  return false;
+  return set_of_states.isInitial(state);
 }
 
 /**
  * Set the state final.
  */
 void Automaton::setStateFinal(int state) {
-  if (hasState(state)) {
-    auto it = set_of_states.find(state);
-    it->second.isFinal = true;
-  }
+  generation++;
+  set_of_states.setFinal(state);
 }
 
 /**
  * Tell if the state is final.
  */
 bool Automaton::isStateFinal(int state) const {
-  if (hasState(state)) {
-    auto it = set_of_states.find(state);
-    if (it->second.isFinal == true) {
-      return true;
-    }
-  }
-  return false;
+  return set_of_states.isFinal(state);
 }
 
 /**
@@ -231,6 +774,7 @@ bool Automaton::isStateFinal(int state) const {
  * added.
  */
 bool Automaton::addTransition(int from, char alpha, int to) {
+  generation++;
   struct Transition t = {from, alpha, to};
   if ((hasSymbol(alpha) || alpha == fa::Epsilon) && hasState(from) &&
       hasState(to) && !hasTransition(from, alpha, to)) {
@@ -247,6 +791,7 @@ bool Automaton::addTransition(int from, char alpha, int to) {
  * Returns true if the transition was effectively removed and false otherwise.
  */
 bool Automaton::removeTransition(int from, char alpha, int to) {
+  generation++;
   struct Transition t = {from, alpha, to};
   if (hasTransition(from, alpha, to)) {
     set_of_transitions.erase(
@@ -278,107 +823,462 @@ std::size_t Automaton::countTransitions() const {
 }
 
 /**
- * Print the automaton in a friendly way
+ * Tell if the states are numbered from 0 to countStates() - 1
  */
-void Automaton::prettyPrint(std::ostream& os) const {
-  os << "Initial states:\n\t";
-  for (auto& s : set_of_states) {
-    if (isStateInitial(s.first)) {
-      os << s.first << ' ';
+bool Automaton::isCompact() const { return set_of_states.isCompact(); }
+
+/**
+ * Renumber the states from 0 to countStates() - 1
+ *
+ * The states are numbered in breadth-first order from the initial
+ * states, following transitions by increasing symbol, so that states
+ * used together get close numbers. The states which are not accessible
+ * come last, by increasing number.
+ * Returns the new number of each state.
+ */
+std::map<int, int> Automaton::compact() {
+  generation++;
+  // Transitions triées par état de départ, symbole puis arrivée
+  std::vector<struct Transition> sorted(set_of_transitions.begin(),
+                                       set_of_transitions.end());
+  std::sort(sorted.begin(), sorted.end(),
+            [](const struct Transition& a, const struct Transition& b) {
+              return std::make_tuple(a.from, a.symbol, a.to) <
+                     std::make_tuple(b.from, b.symbol, b.to);
+            });
+
+  std::map<int, int> numbers;
+  std::vector<int> queue;
+  for (const auto& s : set_of_states) {
+    if (s.second.isInitial) {
+      numbers[s.first] = queue.size();
+      queue.push_back(s.first);
     }
   }
 
-  os << "\nFinal states:\n\t";
-  for (auto& s : set_of_states) {
-    if (isStateFinal(s.first)) {
-      os << s.first << ' ';
+  // Parcours en largeur
+  for (std::size_t i = 0; i < queue.size(); i++) {
+    auto it = std::lower_bound(
+        sorted.begin(), sorted.end(), queue[i],
+        [](const struct Transition& t, int state) { return t.from < state; });
+    for (; it != sorted.end() && it->from == queue[i]; ++it) {
+      if (numbers.find(it->to) == numbers.end()) {
+        numbers[it->to] = queue.size();
+        queue.push_back(it->to);
+      }
     }
   }
 
-  os << "\nTransitions:";
-  for (auto& s : set_of_states) {
-    os << "\n\tFor state " << s.first << " :";
-    for (auto& a : alphabet) {
-      os << "\n\t\tFor letter " << a << " : ";
-      for (auto& t : set_of_transitions) {
-        if (t.from == s.first && t.symbol == a) {
-          os << t.to << ' ';
-        }
-      }
+  // États non accessibles
+  for (const auto& s : set_of_states) {
+    if (numbers.find(s.first) == numbers.end()) {
+      numbers[s.first] = queue.size();
+      queue.push_back(s.first);
     }
   }
-  os << '\n';
+
+  StateTable states(getResource());
+  for (const auto& s : set_of_states) {
+    int number = numbers[s.first];
+    states.insert(number);
+    if (s.second.isInitial) {
+      states.setInitial(number);
+    }
+    if (s.second.isFinal) {
+      states.setFinal(number);
+    }
+  }
+  set_of_states = states;
+
+  for (std::size_t i = 0; i < sorted.size(); i++) {
+    sorted[i].from = numbers[sorted[i].from];
+    sorted[i].to = numbers[sorted[i].to];
+  }
+  set_of_transitions.assign(sorted.begin(), sorted.end());
+
+  return numbers;
 }
 
 /**
- * Tell if the automaton has one or more epsilon-transition
+ * Build an immutable copy of the automaton, optimized for queries
+ *
+ * The transitions are stored in a compressed sparse row layout. Later
+ * changes to the automaton are not reflected in the result.
  */
-bool Automaton::hasEpsilonTransition() const {
-  for (auto& t : set_of_transitions) {
-    if (t.symbol == fa::Epsilon) {
-      return true;
+FrozenAutomaton Automaton::freeze() const { return FrozenAutomaton(*this); }
+
+/**
+ * Permet de regrouper les transitions par état de départ, en conservant leur
+ * ordre : les transitions de states[i] sont rows[offsets[i]..offsets[i + 1]]
+ */
+static void group_transitions(const Automaton& automaton,
+                              std::vector<int>& states,
+                              std::vector<std::size_t>& offsets,
+                              std::vector<const Transition*>& rows) {
+  states.clear();
+  for (const auto& s : automaton.set_of_states) {
+    states.push_back(s.first);
+  }
+  auto index_of = [&](int state) -> std::size_t {
+    return std::lower_bound(states.begin(), states.end(), state) -
+           states.begin();
+  };
+
+  // Tri par comptage, stable
+  offsets.assign(states.size() + 1, 0);
+  for (auto& t : automaton.set_of_transitions) {
+    if (automaton.hasState(t.from)) {
+      offsets[index_of(t.from) + 1]++;
+    }
+  }
+  for (std::size_t i = 0; i < states.size(); i++) {
+    offsets[i + 1] += offsets[i];
+  }
+  rows.assign(offsets.back(), nullptr);
+  std::vector<std::size_t> cursors(offsets.begin(), offsets.end() - 1);
+  for (auto& t : automaton.set_of_transitions) {
+    if (automaton.hasState(t.from)) {
+      rows[cursors[index_of(t.from)]++] = &t;
     }
   }
-  return false;
 }
 
 /**
- * Tell if the automaton is deterministic
+ * Print the automaton in a friendly way
  */
-bool Automaton::isDeterministic() const {
-  int nb_initial_states = 0;
-  int nb_final_states = 0;
-  for (auto& s : set_of_states) {
-    if (isStateInitial(s.first)) {
-      nb_initial_states += 1;
-    }
-    if (isStateFinal(s.first)) {
-      nb_final_states += 1;
+void Automaton::prettyPrint(std::ostream& os) const {
+  os << "Initial states:\n\t";
+  for (const auto& s : set_of_states) {
+    if (s.second.isInitial) {
+      os << s.first << ' ';
     }
   }
 
-  // Un état initial
-  if (nb_initial_states != 1) {
-    return false;
+  os << "\nFinal states:\n\t";
+  for (const auto& s : set_of_states) {
+    if (s.second.isFinal) {
+      os << s.first << ' ';
+    }
   }
 
-  // Gestion des transitions
-  for (auto& t1 : set_of_transitions) {
-    // Pas de Epsilon transition
-    if (t1.symbol == fa::Epsilon) {
-      return false;
+  std::vector<int> states;
+  std::vector<std::size_t> offsets;
+  std::vector<const Transition*> rows;
+  group_transitions(*this, states, offsets, rows);
+
+  os << "\nTransitions:";
+  for (std::size_t i = 0; i < states.size(); i++) {
+    // Tri stable par symbole des transitions de l'état
+    std::stable_sort(rows.begin() + offsets[i], rows.begin() + offsets[i + 1],
+                     [](const Transition* t1, const Transition* t2) {
+                       return t1->symbol < t2->symbol;
+                     });
+    os << "\n\tFor state " << states[i] << " :";
+    std::size_t k = offsets[i];
+    for (char a : alphabet) {
+      os << "\n\t\tFor letter " << a << " : ";
+      while (k < offsets[i + 1] && rows[k]->symbol < a) {
+        k++;
+      }
+      for (; k < offsets[i + 1] && rows[k]->symbol == a; k++) {
+        os << rows[k]->to << ' ';
+      }
     }
+  }
+  os << '\n';
+}
 
-    // Une transition partant d'un état avec le même symbole au maximum
-    for (auto& t2 : set_of_transitions) {
-      if (t1.from == t2.from && t1.symbol == t2.symbol && t1.to != t2.to) {
-        return false;
+/**
+ * Permet d'écrire l'étiquette DOT d'un ensemble de symboles triés
+ */
+static void dot_label(std::ostream& os, std::vector<unsigned char>& symbols,
+                      bool merge_ranges) {
+  // Les octets invisibles, ',' et '-' sont écrits \xHH, comme dans cppPrint
+  auto print_symbol = [&](unsigned char symbol) {
+    if (symbol == static_cast<unsigned char>(Epsilon)) {
+      os << "&epsilon;";
+    } else if (!isgraph(symbol) || symbol == ',' || symbol == '-') {
+      const char* digits = "0123456789abcdef";
+      os << "\\\\x" << digits[symbol / 16] << digits[symbol % 16];
+    } else {
+      if (symbol == '"' || symbol == '\\') {
+        os << '\\';
       }
+      os << static_cast<char>(symbol);
+    }
+  };
+
+  for (std::size_t i = 0; i < symbols.size();) {
+    // Recherche de la suite de symboles consécutifs
+    std::size_t end = i + 1;
+    while (merge_ranges && end < symbols.size() &&
+           symbols[end] == symbols[end - 1] + 1 &&
+           symbols[i] != static_cast<unsigned char>(Epsilon)) {
+      end++;
+    }
+    if (i > 0) {
+      os << ',';
+    }
+    if (end - i >= 3) {
+      print_symbol(symbols[i]);
+      os << '-';
+      print_symbol(symbols[end - 1]);
+      i = end;
+    } else {
+      print_symbol(symbols[i]);
+      i++;
     }
   }
-  return true;
 }
 
 /**
- * Tell if the automaton is complete
+ * Print the automaton with respect to the DOT specification
+ *
+ * The transitions between two states are printed as one edge, labelled
+ * by their symbols. If merge_ranges is true, three or more consecutive
+ * symbols are written as a range, such as a-z. Control and non-ASCII
+ * bytes, ',' and '-' are written \xHH, so that the label stays readable.
  */
-bool Automaton::isComplete() const {
-  bool find = false;
-  // Une transition par symbole à chaque état
-  for (auto& s : set_of_states) {
-    for (auto& a : alphabet) {
-      find = false;
-      for (auto& t : set_of_transitions) {
-        if (t.from == s.first && t.symbol == a) {
-          find = true;
+void Automaton::dotPrint(std::ostream& os, bool merge_ranges) const {
+  os << "digraph automaton {\n";
+  os << "  rankdir = LR;\n";
+  os << "  node [shape = circle];\n";
+
+  for (const auto& s : set_of_states) {
+    os << "  " << s.first;
+    if (s.second.isFinal) {
+      os << " [shape = doublecircle]";
+    }
+    os << ";\n";
+    if (s.second.isInitial) {
+      os << "  initial_" << s.first << " [shape = point, label = \"\"];\n";
+      os << "  initial_" << s.first << " -> " << s.first << ";\n";
+    }
+  }
+
+  std::vector<int> states;
+  std::vector<std::size_t> offsets;
+  std::vector<const Transition*> rows;
+  group_transitions(*this, states, offsets, rows);
+
+  std::vector<unsigned char> symbols;
+  for (std::size_t i = 0; i < states.size(); i++) {
+    // Regroupement des transitions de l'état par état d'arrivée
+    std::sort(rows.begin() + offsets[i], rows.begin() + offsets[i + 1],
+              [](const Transition* t1, const Transition* t2) {
+                return std::make_pair(t1->to,
+                                      static_cast<unsigned char>(t1->symbol)) <
+                       std::make_pair(t2->to,
+                                      static_cast<unsigned char>(t2->symbol));
+              });
+    for (std::size_t k = offsets[i]; k < offsets[i + 1];) {
+      int to = rows[k]->to;
+      symbols.clear();
+      for (; k < offsets[i + 1] && rows[k]->to == to; k++) {
+        if (symbols.empty() ||
+            symbols.back() != static_cast<unsigned char>(rows[k]->symbol)) {
+          symbols.push_back(rows[k]->symbol);
         }
       }
-      if (!find) {
-        return false;
+      os << "  " << states[i] << " -> " << to << " [label = \"";
+      dot_label(os, symbols, merge_ranges);
+      os << "\"];\n";
+    }
+  }
+  os << "}\n";
+}
+
+/**
+ * Permet d'écrire un symbole sous forme de littéral caractère C++
+ */
+static std::string cpp_char_literal(char symbol) {
+  if (symbol == '\'' || symbol == '\\') {
+    return std::string("'\\") + symbol + "'";
+  }
+  if (isgraph(static_cast<unsigned char>(symbol))) {
+    return std::string("'") + symbol + "'";
+  }
+  const char* digits = "0123456789abcdef";
+  unsigned char byte = symbol;
+  return std::string("'\\x") + digits[byte / 16] + digits[byte % 16] + "'";
+}
+
+/**
+ * Print a standalone C++ function accepting the language of the automaton
+ *
+ * The function is declared as
+ *   inline bool function_name(const char* text, std::size_t length)
+ * and simulates the minimal automaton, either with a switch on the
+ * current state in a loop, or with one label per state and gotos. The
+ * dead state is replaced by an early return. Like Automaton::match,
+ * epsilon-transitions are not followed.
+ */
+void Automaton::cppPrint(std::ostream& os, const std::string& function_name,
+                         CodeStyle style) const {
+  // Un automate déjà déterministe garde ses états inaccessibles, numérotés
+  // en dernier par compact : les retirer laisse les états 0 à nb_states - 1
+  Automaton minimal = createMinimalMoore(*this);
+  minimal.removeNonAccessibleStates();
+  std::size_t nb_states = minimal.countStates();
+
+  // Symboles de chaque transition, regroupés par état d'arrivée
+  std::vector<std::map<int, std::vector<char>>> targets(nb_states);
+  for (auto& t : minimal.set_of_transitions) {
+    targets[t.from][t.to].push_back(t.symbol);
+  }
+
+  // L'état puits, non final et sans autre successeur que lui-même
+  std::vector<bool> dead(nb_states, false);
+  for (std::size_t s = 0; s < nb_states; s++) {
+    dead[s] = !minimal.isStateFinal(s) &&
+              (targets[s].empty() ||
+               (targets[s].size() == 1 &&
+                targets[s].begin()->first == static_cast<int>(s)));
+  }
+  int initial = minimal.getInitialStates()[0];
+
+  os << "// Generated from a minimal automaton with " << nb_states
+     << " states\n";
+  os << "#include <cstddef>\n\n";
+  os << "inline bool " << function_name
+     << "(const char* text, std::size_t length) {\n";
+
+  if (dead[initial]) {
+    os << "  (void)text;\n  (void)length;\n  return false;\n}\n";
+    return;
+  }
+
+  // Les cas d'un switch sur le symbole courant, pour un état
+  auto print_cases = [&](std::size_t s, const std::string& indent,
+                         bool with_goto) {
+    for (auto& target : targets[s]) {
+      if (dead[target.first]) {
+        continue;
+      }
+      for (char symbol : target.second) {
+        os << indent << "case " << cpp_char_literal(symbol) << ":\n";
+      }
+      if (with_goto) {
+        os << indent << "  goto state_" << target.first << ";\n";
+      } else {
+        os << indent << "  state = " << target.first << ";\n";
+        os << indent << "  break;\n";
+      }
+    }
+    os << indent << "default:\n";
+    os << indent << "  return false;\n";
+  };
+
+  if (style == CodeStyle::Switch) {
+    os << "  int state = " << initial << ";\n";
+    os << "  for (std::size_t i = 0; i < length; i++) {\n";
+    os << "    switch (state) {\n";
+    for (std::size_t s = 0; s < nb_states; s++) {
+      if (dead[s]) {
+        continue;
+      }
+      os << "    case " << s << ":\n";
+      os << "      switch (text[i]) {\n";
+      print_cases(s, "      ", false);
+      os << "      }\n";
+      os << "      break;\n";
+    }
+    os << "    }\n";
+    os << "  }\n";
+    os << "  switch (state) {\n";
+    for (std::size_t s = 0; s < nb_states; s++) {
+      if (minimal.isStateFinal(s)) {
+        os << "  case " << s << ":\n";
+      }
+    }
+    os << "    return true;\n";
+    os << "  default:\n";
+    os << "    return false;\n";
+    os << "  }\n";
+  } else {
+    os << "  const char* end = text + length;\n";
+    os << "  goto state_" << initial << ";\n";
+    for (std::size_t s = 0; s < nb_states; s++) {
+      if (dead[s]) {
+        continue;
       }
+      os << "state_" << s << ":\n";
+      os << "  if (text == end) {\n";
+      os << "    return " << (minimal.isStateFinal(s) ? "true" : "false")
+         << ";\n";
+      os << "  }\n";
+      os << "  switch (*text++) {\n";
+      print_cases(s, "  ", true);
+      os << "  }\n";
     }
   }
-  return true;
+  os << "}\n";
+}
+
+/**
+ * Tell if the automaton has one or more epsilon-transition
+ */
+bool Automaton::hasEpsilonTransition() const {
+  return get_properties()->has_epsilon;
+}
+
+/**
+ * Tell if the automaton is deterministic
+ */
+bool Automaton::isDeterministic() const {
+  return get_properties()->deterministic;
+}
+
+/**
+ * Tell if the automaton is complete
+ */
+bool Automaton::isComplete() const { return get_properties()->complete; }
+
+/**
+ * Find the first reason why the automaton is not deterministic
+ *
+ * The states are checked by increasing number. If there is not exactly
+ * one initial state, the result has no state when there is none, or the
+ * second initial state. Otherwise, it gives the state with an
+ * epsilon-transition (and the symbol Epsilon), or with two transitions
+ * on the same symbol.
+ */
+PropertyViolation Automaton::findNonDeterminism() const {
+  if (isDeterministic()) {
+    return {false, -1, fa::Epsilon};
+  }
+  return freeze().findNonDeterminism();
+}
+
+/**
+ * Find the first state and symbol without transition
+ *
+ * The states are checked by increasing number, and the symbols in order.
+ */
+PropertyViolation Automaton::findMissingTransition() const {
+  if (isComplete()) {
+    return {false, -1, fa::Epsilon};
+  }
+  return freeze().findMissingTransition();
+}
+
+/**
+ * Tell if every state is accessible and co-accessible
+ */
+bool Automaton::isTrimmed() const { return get_properties()->trimmed; }
+
+/**
+ * Get the initial states, by increasing number
+ */
+std::vector<int> Automaton::getInitialStates() const {
+  return get_properties()->initial_states;
+}
+
+/**
+ * Count the number of final states
+ */
+std::size_t Automaton::countFinalStates() const {
+  return get_properties()->nb_final_states;
 }
 
 /**
@@ -413,14 +1313,19 @@ void Automaton::find_state(std::set<int>& statesBrowseGlobal,
  * Remove non-accessible states
  */
 void Automaton::removeNonAccessibleStates() {
+  // Rien à supprimer si l'automate est émondé
+  if (isTrimmed()) {
+    return;
+  }
+  generation++;
   std::set<int> statesBrowseGlobal;
   std::set<int> statesBrowseLocal;
 
   // Trouver états initiaux
-  for (auto& s_initial : set_of_states) {
+  for (const auto& s_initial : set_of_states) {
     if (isStateInitial(s_initial.first)) {
       // Recherche d'accès aux états
-      for (auto& s_to_find : set_of_states) {
+      for (const auto& s_to_find : set_of_states) {
         statesBrowseLocal.clear();
         if (statesBrowseGlobal.find(s_to_find.first) !=
             statesBrowseGlobal.end()) {
@@ -450,14 +1355,15 @@ void Automaton::removeNonAccessibleStates() {
   }
 
   // Suppprimer les états qui n'ont pas été trouvé
-  for (auto iterator = set_of_states.begin();
-       iterator != set_of_states.end();) {
-    if (statesBrowseGlobal.find(iterator->first) == statesBrowseGlobal.end()) {
-      set_of_states.erase(iterator++);
-    } else {
-      ++iterator;
+  std::vector<int> states_to_delete;
+  for (const auto& s : set_of_states) {
+    if (statesBrowseGlobal.find(s.first) == statesBrowseGlobal.end()) {
+      states_to_delete.push_back(s.first);
     }
   }
+  for (int state : states_to_delete) {
+    set_of_states.erase(state);
+  }
 
   // On renvoie un automate valide
   if (countStates() == 0) {
@@ -504,11 +1410,16 @@ void Automaton::find_final_state(std::set<int>& statesBrowseGlobal,
  * Remove non-co-accessible states
  */
 void Automaton::removeNonCoAccessibleStates() {
+  // Rien à supprimer si l'automate est émondé
+  if (isTrimmed()) {
+    return;
+  }
+  generation++;
   std::set<int> statesBrowseGlobal;
   std::set<int> statesBrowseLocal;
 
   // Parcourir tous les états
-  for (auto& s : set_of_states) {
+  for (const auto& s : set_of_states) {
     statesBrowseLocal.clear();
     find_final_state(statesBrowseGlobal, statesBrowseLocal, s.first, s.first);
   }
@@ -531,14 +1442,15 @@ void Automaton::removeNonCoAccessibleStates() {
   }
 
   // Suppprimer les états qui n'ont pas été trouvé
-  for (auto iterator = set_of_states.begin();
-       iterator != set_of_states.end();) {
-    if (statesBrowseGlobal.find(iterator->first) == statesBrowseGlobal.end()) {
-      set_of_states.erase(iterator++);
-    } else {
-      ++iterator;
+  std::vector<int> states_to_delete;
+  for (const auto& s : set_of_states) {
+    if (statesBrowseGlobal.find(s.first) == statesBrowseGlobal.end()) {
+      states_to_delete.push_back(s.first);
     }
   }
+  for (int state : states_to_delete) {
+    set_of_states.erase(state);
+  }
 
   // On renvoie un automate valide
   if (countStates() == 0) {
@@ -551,64 +1463,11 @@ void Automaton::removeNonCoAccessibleStates() {
   }
 }
 
-/**
- * Permet de parcourir l'automate pour voir s'il a un langage vide
- */
-void Automaton::browse_automaton(std::set<int> statesBrowse, int state,
-                                 int& nb) const {
-  if (statesBrowse.find(state) != statesBrowse.end()) {
-    return;
-  }
-
-  statesBrowse.insert(state);
-
-  if (isStateFinal(state) == true) {
-    nb++;
-    return;
-  }
-
-  if (isStateFinal(state) == false) {
-    for (auto& t : set_of_transitions) {
-      if (t.from == state) {
-        browse_automaton(statesBrowse, t.to, nb);
-      }
-    }
-  }
-}
-
 /**
  * Check if the language of the automaton is empty
  */
 bool Automaton::isLanguageEmpty() const {
-  int nb_initial_states = 0;
-  int nb_final_states = 0;
-
-  std::set<int> empty_set = {};
-
-  for (auto& s : set_of_states) {
-    if (isStateInitial(s.first)) {
-      nb_initial_states++;
-    }
-    if (isStateFinal(s.first)) {
-      nb_final_states++;
-    }
-  }
-  if (nb_final_states == 0 || nb_initial_states == 0) {
-    return true;
-  }
-
-  std::set<int> statesBrowse;
-  int nb_chemins = 0;
-  // Trouver états initiaux
-  for (auto& s : set_of_states) {
-    if (isStateInitial(s.first)) {
-      browse_automaton(statesBrowse, s.first, nb_chemins);
-      if (nb_chemins > 0) {
-        return false;
-      }
-    }
-  }
-  return true;
+  return get_properties()->language_empty;
 }
 
 /**
@@ -640,41 +1499,71 @@ std::set<int> Automaton::state_after_move(char next_symbol,
   return new_states;
 }
 
+//Structure de l'automate compilé, jamais modifiée une fois publiée
+struct Automaton::Matcher {
+  std::size_t generation;
+  std::unique_ptr<BitParallelAutomaton> bit_parallel; // petits automates
+  std::unique_ptr<FrozenAutomaton> frozen;            // sinon
+};
+
 /**
- * Read the string and compute the state set after traversing the automaton
+ * Permet d'obtenir l'automate compilé utilisé pour la lecture, construit si besoin
  */
-std::set<int> Automaton::readString(const std::string& word) const {
-  std::set<int> states;
-  // Trouver états initiaux
-  for (auto& s_initial : set_of_states) {
-    if (isStateInitial(s_initial.first)) {
-      states.insert(s_initial.first);
-    }
+std::shared_ptr<const Automaton::Matcher> Automaton::get_matcher() const {
+  std::shared_ptr<const Matcher> cached = std::atomic_load(&matcher);
+  if (cached != nullptr && cached->generation == generation) {
+    return cached;
   }
 
-  // Parcourir les états
-  for (std::size_t i = 0; i < word.length(); i++) {
-    states = state_after_move(word[i], states);
+  auto compiled = std::make_shared<Matcher>();
+  compiled->generation = generation;
+  // Simulation bit-parallèle pour les petits automates
+  if (countStates() <= BitParallelAutomaton::MaxStates) {
+    compiled->bit_parallel = std::make_unique<BitParallelAutomaton>(*this);
+  } else {
+    compiled->frozen = std::make_unique<FrozenAutomaton>(*this);
   }
 
-  return states;
+  std::shared_ptr<const Matcher> published = std::move(compiled);
+  std::atomic_store(&matcher, published);
+  return published;
+}
+
+/**
+ * Read the string and compute the state set after traversing the automaton
+ *
+ * The automaton is compiled by the first reading, and the compiled form
+ * is cached like the structural properties, until the next modification.
+ */
+std::set<int> Automaton::readString(const std::string& word) const {
+  std::shared_ptr<const Matcher> compiled = get_matcher();
+  if (compiled->bit_parallel != nullptr) {
+    return compiled->bit_parallel->readString(word);
+  }
+  return compiled->frozen->readString(word);
 }
 
 /**
  * Tell if the word is in the language accepted by the automaton
+ *
+ * Like readString, the compiled form of the automaton is cached.
  */
 bool Automaton::match(const std::string& word) const {
-  std::set acccessible_states = readString(word);
-  if (acccessible_states.empty()) {
-    return false;
-  }
-  for (auto& state : acccessible_states) {
-    if (isStateFinal(state)) {
-      return true;
-    }
+  std::shared_ptr<const Matcher> compiled = get_matcher();
+  if (compiled->bit_parallel != nullptr) {
+    return compiled->bit_parallel->match(word);
   }
+  return compiled->frozen->match(word);
+}
 
-  return false;
+/**
+ * Find the leftmost-longest factor of the text in the language
+ *
+ * The result gives the offsets [start, end) of the factor. To search
+ * several texts, build a SubstringSearcher once instead.
+ */
+SearchResult Automaton::search(std::string_view text) const {
+  return SubstringSearcher(*this).search(text);
 }
 
 /**
@@ -710,9 +1599,10 @@ bool Automaton::isIncludedIn(const Automaton& other) const {
  * Create a mirror automaton
  */
 Automaton Automaton::createMirror(const Automaton& automaton) {
-  Automaton automaton_local;
+  FA_STATS_SCOPE("createMirror");
+  Automaton automaton_local(automaton.getResource());
 
-  for (auto& s : automaton.set_of_states) {
+  for (const auto& s : automaton.set_of_states) {
     automaton_local.addState(s.first);
     if (automaton.isStateFinal(s.first)) {
       automaton_local.setStateInitial(s.first);
@@ -722,13 +1612,14 @@ Automaton Automaton::createMirror(const Automaton& automaton) {
     }
   }
 
-  for (auto& a : automaton.alphabet) {
+  for (char a : automaton.alphabet) {
     automaton_local.addSymbol(a);
   }
 
   for (auto& t : automaton.set_of_transitions) {
     automaton_local.addTransition(t.to, t.symbol, t.from);
   }
+  FA_STATS_RESULT(automaton_local);
   return automaton_local;
 }
 
@@ -736,20 +1627,23 @@ Automaton Automaton::createMirror(const Automaton& automaton) {
  * Create a complete automaton, if not already complete
  */
 Automaton Automaton::createComplete(const Automaton& automaton) {
+  FA_STATS_SCOPE("createComplete");
+  // Copie dans la ressource mémoire de l'automate
+  Automaton automaton_local(automaton.getResource());
+  automaton_local = automaton;
   if (automaton.isComplete()) {
-    return automaton;
+    return automaton_local;
   }
   long new_state = 0;
 
-  Automaton automaton_local = automaton;
   while (automaton.hasState(new_state)) {
     new_state += 1;
   }
   automaton_local.addState(new_state);
 
   bool hasSymbolTransition = false;
-  for (auto& a : automaton_local.alphabet) {
-    for (auto& s : automaton_local.set_of_states) {
+  for (char a : automaton_local.alphabet) {
+    for (const auto& s : automaton_local.set_of_states) {
       for (auto& t : automaton_local.set_of_transitions) {
         if (t.from == s.first && t.symbol == a) {
           hasSymbolTransition = true;
@@ -762,6 +1656,7 @@ Automaton Automaton::createComplete(const Automaton& automaton) {
       hasSymbolTransition = false;
     }
   }
+  FA_STATS_RESULT(automaton_local);
   return automaton_local;
 }
 
@@ -769,13 +1664,18 @@ Automaton Automaton::createComplete(const Automaton& automaton) {
  * Create a complement automaton
  */
 Automaton Automaton::createComplement(const Automaton& automaton) {
-  Automaton complete_deterministic_automaton = createComplete(automaton);
+  FA_STATS_SCOPE("createComplement");
+  // Les automates intermédiaires sont libérés d'un coup avec l'arène
+  std::pmr::monotonic_buffer_resource arena;
+  Automaton local(&arena);
+  local = automaton;
+  Automaton complete_deterministic_automaton = createComplete(local);
   complete_deterministic_automaton =
       complete_deterministic_automaton.createDeterministic(
           complete_deterministic_automaton);
 
-  Automaton automaton_local;
-  for (auto& s : complete_deterministic_automaton.set_of_states) {
+  Automaton automaton_local(automaton.getResource());
+  for (const auto& s : complete_deterministic_automaton.set_of_states) {
     automaton_local.addState(s.first);
     if (!complete_deterministic_automaton.isStateFinal(s.first)) {
       automaton_local.setStateFinal(s.first);
@@ -785,7 +1685,7 @@ Automaton Automaton::createComplement(const Automaton& automaton) {
     }
   }
 
-  for (auto& a : complete_deterministic_automaton.alphabet) {
+  for (char a : complete_deterministic_automaton.alphabet) {
     automaton_local.addSymbol(a);
   }
 
@@ -793,72 +1693,191 @@ Automaton Automaton::createComplement(const Automaton& automaton) {
     automaton_local.addTransition(t.from, t.symbol, t.to);
   }
 
+  FA_STATS_RESULT(automaton_local);
+  return automaton_local;
+}
+
+/**
+ * Create an equivalent automaton without epsilon-transition
+ *
+ * Each state gets the transitions and the finality of the states it
+ * reaches through epsilon-transitions.
+ */
+Automaton Automaton::createWithoutEpsilon(const Automaton& automaton) {
+  FA_STATS_SCOPE("createWithoutEpsilon");
+  std::map<int, std::vector<struct Transition>> transitions_from;
+  for (auto& t : automaton.set_of_transitions) {
+    transitions_from[t.from].push_back(t);
+  }
+
+  Automaton automaton_local(automaton.getResource());
+  automaton_local.alphabet = automaton.alphabet;
+  automaton_local.set_of_states = automaton.set_of_states;
+
+  for (const auto& s : automaton.set_of_states) {
+    // Fermeture par epsilon-transitions de l'état
+    std::set<int> closure = {s.first};
+    std::vector<int> to_visit = {s.first};
+    while (!to_visit.empty()) {
+      int state = to_visit.back();
+      to_visit.pop_back();
+      for (auto& t : transitions_from[state]) {
+        if (t.symbol == Epsilon && closure.insert(t.to).second) {
+          to_visit.push_back(t.to);
+        }
+      }
+    }
+
+    std::set<std::pair<char, int>> targets;
+    for (int state : closure) {
+      if (automaton.isStateFinal(state)) {
+        automaton_local.setStateFinal(s.first);
+      }
+      for (auto& t : transitions_from[state]) {
+        if (t.symbol != Epsilon) {
+          targets.insert({t.symbol, t.to});
+        }
+      }
+    }
+    for (auto& target : targets) {
+      automaton_local.set_of_transitions.push_back(
+          {s.first, target.first, target.second});
+    }
+  }
+  automaton_local.invalidate();
+  FA_STATS_RESULT(automaton_local);
+
   return automaton_local;
 }
 
+/**
+ * Permet de vérifier les options d'une construction après l'exploration
+ * d'un état : annulation, budget d'états, puis progression
+ */
+static ConstructionStatus check_construction(const ConstructionOptions& options,
+                                             std::size_t nb_explored,
+                                             std::size_t nb_states) {
+  if (options.cancel != nullptr &&
+      options.cancel->load(std::memory_order_relaxed)) {
+    return ConstructionStatus::Cancelled;
+  }
+  if (options.max_states != 0 && nb_states > options.max_states) {
+    return ConstructionStatus::BudgetExceeded;
+  }
+  if (options.progress && options.progress_interval != 0 &&
+      nb_explored % options.progress_interval == 0) {
+    options.progress(nb_explored);
+  }
+  return ConstructionStatus::Completed;
+}
+
 /**
  * Create the product of two automata
  *
  * The product of two automata accept the intersection of the two languages.
  */
 Automaton Automaton::createProduct(const Automaton& lhs, const Automaton& rhs) {
-  Automaton product_automaton;
-  std::map<int, std::pair<int, int>> states_product;
-
-  // Création du set regroupant les nouveaux états et leurs états de départ
-  int nb_new_state = 0;
-  for (auto& s_lhs : lhs.set_of_states) {
-    for (auto& s_rhs : rhs.set_of_states) {
-      std::pair<int, int> state_lhs_x_rhs = {s_lhs.first, s_rhs.first};
-      states_product.insert({nb_new_state, state_lhs_x_rhs});
-      nb_new_state++;
-    }
-  }
-
-  // Ajout des états à l'automate produit, en ajoutant final et initial
-  for (auto& s : states_product) {
-    int num_etat_lhs = s.second.first;
-    int num_etat_rhs = s.second.second;
-    product_automaton.addState(s.first);
-
-    if (lhs.isStateInitial(num_etat_lhs) && rhs.isStateInitial(num_etat_rhs)) {
-      product_automaton.setStateInitial(s.first);
-    }
-
-    if (lhs.isStateFinal(num_etat_lhs) && rhs.isStateFinal(num_etat_rhs)) {
-      product_automaton.setStateFinal(s.first);
-    }
-  }
-
-  // Parcours de chaque états pour ajouter les transitions
-  for (auto& s1 : states_product) {
-    int num_etat_depart = s1.first;
-    int from_lhs1 = s1.second.first;
-    int from_rhs1 = s1.second.second;
-    // parcours des transitions de lhs
-    for (auto& t_lhs : lhs.set_of_transitions) {
-      if (from_lhs1 == t_lhs.from) {
-        // parcours des transitions de rhs
-        for (auto& t_rhs : rhs.set_of_transitions) {
-          if (from_rhs1 == t_rhs.from && t_lhs.symbol == t_rhs.symbol) {
-            // Trouver le numéro de l'état à relier
-            for (auto& s2 : states_product) {
-              int num_etat_arriver = s2.first;
-              int arriver_lhs2 = s2.second.first;
-              int arriver_rhs2 = s2.second.second;
-              if (arriver_lhs2 == t_lhs.to && arriver_rhs2 == t_rhs.to) {
-                if (!product_automaton.hasSymbol(t_rhs.symbol)) {
-                  product_automaton.addSymbol(t_rhs.symbol);
-                }
-                product_automaton.addTransition(num_etat_depart, t_rhs.symbol,
-                                                num_etat_arriver);
-              }
+  return createProduct(lhs, rhs, ConstructionOptions()).automaton;
+}
+
+/**
+ * Create the product of two automata, with a budget of states
+ *
+ * Only the pairs of states accessible from the initial pairs are built.
+ * The construction stops when it would exceed options.max_states states
+ * or when options.cancel becomes true.
+ */
+ConstructionResult Automaton::createProduct(const Automaton& lhs,
+                                            const Automaton& rhs,
+                                            const ConstructionOptions& options) {
+  FA_STATS_SCOPE("createProduct");
+  Automaton product_automaton(lhs.getResource());
+
+  // Transitions sortantes de chaque état, triées par symbole
+  std::map<int, std::vector<std::pair<char, int>>> transitions_lhs;
+  std::map<int, std::vector<std::pair<char, int>>> transitions_rhs;
+  for (auto& t : lhs.set_of_transitions) {
+    transitions_lhs[t.from].push_back({t.symbol, t.to});
+  }
+  for (auto& t : rhs.set_of_transitions) {
+    transitions_rhs[t.from].push_back({t.symbol, t.to});
+  }
+  for (auto& transitions : transitions_lhs) {
+    std::sort(transitions.second.begin(), transitions.second.end());
+  }
+  for (auto& transitions : transitions_rhs) {
+    std::sort(transitions.second.begin(), transitions.second.end());
+  }
+
+  // Couples d'états numérotés par ordre de découverte depuis les initiaux
+  std::vector<std::pair<int, int>> states_product;
+  std::map<std::pair<int, int>, int> numbers;
+  auto number_of = [&](int state_lhs, int state_rhs) {
+    auto it = numbers.find({state_lhs, state_rhs});
+    if (it != numbers.end()) {
+      return it->second;
+    }
+    int number = states_product.size();
+    numbers.insert({{state_lhs, state_rhs}, number});
+    states_product.push_back({state_lhs, state_rhs});
+    product_automaton.addState(number);
+    if (lhs.isStateFinal(state_lhs) && rhs.isStateFinal(state_rhs)) {
+      product_automaton.setStateFinal(number);
+    }
+    return number;
+  };
+
+  for (int initial_lhs : lhs.getInitialStates()) {
+    for (int initial_rhs : rhs.getInitialStates()) {
+      product_automaton.setStateInitial(number_of(initial_lhs, initial_rhs));
+    }
+  }
+
+  const std::vector<std::pair<char, int>> no_transition;
+  for (std::size_t current = 0; current < states_product.size(); current++) {
+    FA_STATS_ADD(macrostates_explored, 1);
+    auto it_lhs = transitions_lhs.find(states_product[current].first);
+    auto it_rhs = transitions_rhs.find(states_product[current].second);
+    const auto& from_lhs =
+        it_lhs == transitions_lhs.end() ? no_transition : it_lhs->second;
+    const auto& from_rhs =
+        it_rhs == transitions_rhs.end() ? no_transition : it_rhs->second;
+
+    // Parcours simultané des deux listes triées par symbole
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < from_lhs.size() && j < from_rhs.size()) {
+      if (from_lhs[i].first < from_rhs[j].first) {
+        i++;
+      } else if (from_rhs[j].first < from_lhs[i].first) {
+        j++;
+      } else {
+        char symbol = from_lhs[i].first;
+        std::size_t end_j = j;
+        while (end_j < from_rhs.size() && from_rhs[end_j].first == symbol) {
+          end_j++;
+        }
+        for (; i < from_lhs.size() && from_lhs[i].first == symbol; i++) {
+          for (std::size_t k = j; k < end_j; k++) {
+            int to = number_of(from_lhs[i].second, from_rhs[k].second);
+            if (symbol != fa::Epsilon) {
+              product_automaton.alphabet.insert(symbol);
             }
+            product_automaton.set_of_transitions.push_back(
+                {static_cast<int>(current), symbol, to});
           }
         }
+        j = end_j;
       }
     }
+
+    ConstructionStatus status =
+        check_construction(options, current + 1, states_product.size());
+    if (status != ConstructionStatus::Completed) {
+      return {status, Automaton(lhs.getResource())};
+    }
   }
+  product_automaton.invalidate();
 
   // On renvoie un automate valide
   if (product_automaton.countStates() == 0) {
@@ -870,130 +1889,393 @@ Automaton Automaton::createProduct(const Automaton& lhs, const Automaton& rhs) {
     product_automaton.addSymbol('a');
   }
 
-  return product_automaton;
+  FA_STATS_RESULT(product_automaton);
+  return {ConstructionStatus::Completed, std::move(product_automaton)};
 }
 
 /**
- * Create a deterministic automaton, if not already deterministic
+ * Copie les états (sans leurs drapeaux), les symboles et les transitions de
+ * l'automate source, en numérotant ses états à partir de first_state.
+ * Renvoie la correspondance entre anciens et nouveaux numéros.
  */
-Automaton Automaton::createDeterministic(const Automaton& other) {
-  if (other.isDeterministic()) {
-    return other;
-  }
-
-  /**
-   * Remplissage de la table
-   */
+static std::map<int, int> copy_automaton(const Automaton& source,
+                                         int first_state, Automaton& target) {
+  std::map<int, int> numbers;
+  for (const auto& s : source.set_of_states) {
+    int number = first_state + numbers.size();
+    numbers[s.first] = number;
+    target.addState(number);
+  }
+  target.alphabet.insert(source.alphabet.begin(), source.alphabet.end());
+  for (auto& t : source.set_of_transitions) {
+    target.set_of_transitions.push_back(
+        {numbers[t.from], t.symbol, numbers[t.to]});
+  }
+  target.invalidate();
+  return numbers;
+}
 
-  // Trouver les états initiaux
-  std::set<int> states;
-  int nb_etats_initiaux = 0;
-  for (auto& s : other.set_of_states) {
-    if (other.isStateInitial(s.first)) {
-      states.insert(s.first);
-      nb_etats_initiaux++;
+/**
+ * Permet d'obtenir les transitions (symbole, arrivée) partant des états
+ * initiaux de l'automate
+ */
+static std::set<std::pair<char, int>> initial_transitions(
+    const Automaton& automaton, std::map<int, int>& numbers) {
+  std::set<std::pair<char, int>> transitions;
+  for (auto& t : automaton.set_of_transitions) {
+    if (automaton.isStateInitial(t.from)) {
+      transitions.insert({t.symbol, numbers[t.to]});
     }
   }
+  return transitions;
+}
 
-  // Regarder si l'ensemble d'états du set appartient déjà à la map
-  std::vector<Determinisation> table_determinisme;
-  std::vector<Correspondance> table_correspondance;
+/**
+ * Sort transitions by origin, symbol and destination, and remove the duplicates
+ *
+ * Shared by the code which adds transitions in bulk to set_of_transitions.
+ */
+void removeDuplicateTransitions(
+    std::pmr::vector<struct Transition>& transitions) {
+  auto key = [](const struct Transition& t) {
+    return std::make_tuple(t.from, t.symbol, t.to);
+  };
+  std::sort(transitions.begin(), transitions.end(),
+            [&](const struct Transition& a, const struct Transition& b) {
+              return key(a) < key(b);
+            });
+  transitions.erase(std::unique(transitions.begin(), transitions.end(),
+                                [&](const struct Transition& a,
+                                    const struct Transition& b) {
+                                  return key(a) == key(b);
+                                }),
+                    transitions.end());
+}
 
-  // Ajout du set de départ à la table de correspondance
-  table_correspondance.push_back({0, states});
+/**
+ * Create the union of two automata
+ *
+ * The union of two automata accept the union of the two languages.
+ */
+Automaton Automaton::createUnion(const Automaton& lhs, const Automaton& rhs) {
+  FA_STATS_SCOPE("createUnion");
+  Automaton union_automaton(lhs.getResource());
+  std::map<int, int> numbers_lhs = copy_automaton(lhs, 0, union_automaton);
+  std::map<int, int> numbers_rhs =
+      copy_automaton(rhs, lhs.countStates(), union_automaton);
+
+  for (const auto& s : lhs.set_of_states) {
+    if (s.second.isInitial) {
+      union_automaton.setStateInitial(numbers_lhs[s.first]);
+    }
+    if (s.second.isFinal) {
+      union_automaton.setStateFinal(numbers_lhs[s.first]);
+    }
+  }
+  for (const auto& s : rhs.set_of_states) {
+    if (s.second.isInitial) {
+      union_automaton.setStateInitial(numbers_rhs[s.first]);
+    }
+    if (s.second.isFinal) {
+      union_automaton.setStateFinal(numbers_rhs[s.first]);
+    }
+  }
 
-  int ligne_en_cours_de_calcul = 0;
-  int num_etat = 1;
+  // On renvoie un automate valide
+  if (union_automaton.countStates() == 0) {
+    union_automaton.addState(0);
+    union_automaton.setStateInitial(0);
+  }
 
-  while (ligne_en_cours_de_calcul < num_etat) {
-    for (auto& t : table_correspondance) {
-      if (t.nouvel_etat == ligne_en_cours_de_calcul) {
-        std::set<int> etat_en_cours = t.ensemble_etats;
-        // Calcul pour toute les lettres de l'alphabet
-        std::vector<std::set<int>> elements_ligne_map;
+  if (union_automaton.countSymbols() == 0) {
+    union_automaton.addSymbol('a');
+  }
+  FA_STATS_RESULT(union_automaton);
 
-        for (auto& a : other.alphabet) {
-          std::set<int> etats_accessible =
-              other.state_after_move(a, etat_en_cours);
-          table_determinisme.push_back({etat_en_cours, a, etats_accessible});
+  return union_automaton;
+}
 
-          // Ajout à la table de correspondance si non présent
-          bool isPresent = false;
-          for (auto& t : table_correspondance) {
-            if (t.ensemble_etats == etats_accessible) {
-              isPresent = true;
-              break;
-            }
-          }
-          if (!isPresent) {
-            table_correspondance.push_back({num_etat, etats_accessible});
-            num_etat++;
-          }
+/**
+ * Create the concatenation of two automata
+ *
+ * If with_epsilon is true, the final states of lhs are linked to the
+ * initial states of rhs by epsilon-transitions. Otherwise, the final
+ * states of lhs get the transitions leaving the initial states of rhs.
+ */
+Automaton Automaton::createConcatenation(const Automaton& lhs,
+                                         const Automaton& rhs,
+                                         bool with_epsilon) {
+  FA_STATS_SCOPE("createConcatenation");
+  Automaton concatenation(lhs.getResource());
+  std::map<int, int> numbers_lhs = copy_automaton(lhs, 0, concatenation);
+  std::map<int, int> numbers_rhs =
+      copy_automaton(rhs, lhs.countStates(), concatenation);
+
+  // rhs reconnait-il le mot vide ?
+  bool rhs_empty_word = false;
+  for (const auto& s : rhs.set_of_states) {
+    if (s.second.isInitial && s.second.isFinal) {
+      rhs_empty_word = true;
+    }
+    if (s.second.isFinal) {
+      concatenation.setStateFinal(numbers_rhs[s.first]);
+    }
+  }
+
+  std::set<std::pair<char, int>> rhs_initial_transitions =
+      initial_transitions(rhs, numbers_rhs);
+
+  for (const auto& s : lhs.set_of_states) {
+    int state = numbers_lhs[s.first];
+    if (s.second.isInitial) {
+      concatenation.setStateInitial(state);
+    }
+    if (!s.second.isFinal) {
+      continue;
+    }
+
+    if (with_epsilon) {
+      for (const auto& s_rhs : rhs.set_of_states) {
+        if (s_rhs.second.isInitial) {
+          concatenation.set_of_transitions.push_back(
+              {state, Epsilon, numbers_rhs[s_rhs.first]});
         }
-        ligne_en_cours_de_calcul++;
-        break;
+      }
+    } else {
+      if (rhs_empty_word) {
+        concatenation.setStateFinal(state);
+      }
+      // Les transitions copiées mènent dans rhs : pas de doublon possible
+      for (auto& t : rhs_initial_transitions) {
+        concatenation.set_of_transitions.push_back({state, t.first, t.second});
       }
     }
   }
+  concatenation.invalidate();
 
-  /**
-   * Création de l'automate
-   */
-  Automaton deterministic_automaton;
+  // On renvoie un automate valide
+  if (concatenation.countStates() == 0) {
+    concatenation.addState(0);
+    concatenation.setStateInitial(0);
+  }
 
-  // Ajout alphabet
-  std::vector<char> alphabet_tab;
-  for (auto& a : other.alphabet) {
-    deterministic_automaton.addSymbol(a);
-    alphabet_tab.push_back(a);
+  if (concatenation.countSymbols() == 0) {
+    concatenation.addSymbol('a');
   }
+  FA_STATS_RESULT(concatenation);
 
-  // Ajout des états
-  for (auto& ligne : table_correspondance) {
-    deterministic_automaton.addState(ligne.nouvel_etat);
-    bool all_initial = true;
-    int nb_etat = 0;
-    for (auto& etat_other : ligne.ensemble_etats) {
-      nb_etat++;
-      if (other.isStateFinal(etat_other)) {
-        deterministic_automaton.setStateFinal(ligne.nouvel_etat);
+  return concatenation;
+}
+
+/**
+ * Create the Kleene star of an automaton
+ *
+ * A new state, initial and final, accepts the empty word. If with_epsilon
+ * is true, it is linked to the initial states and the final states are
+ * linked back to it by epsilon-transitions. Otherwise, it and the final
+ * states get the transitions leaving the initial states.
+ */
+Automaton Automaton::createKleeneStar(const Automaton& automaton,
+                                      bool with_epsilon) {
+  FA_STATS_SCOPE("createKleeneStar");
+  Automaton star(automaton.getResource());
+  std::map<int, int> numbers = copy_automaton(automaton, 1, star);
+
+  // Nouvel état reconnaissant le mot vide
+  star.addState(0);
+  star.setStateInitial(0);
+  star.setStateFinal(0);
+
+  std::set<std::pair<char, int>> transitions =
+      initial_transitions(automaton, numbers);
+
+  for (const auto& s : automaton.set_of_states) {
+    int state = numbers[s.first];
+    if (s.second.isFinal) {
+      star.setStateFinal(state);
+    }
+
+    if (with_epsilon) {
+      if (s.second.isInitial) {
+        star.set_of_transitions.push_back({0, Epsilon, state});
+      }
+      if (s.second.isFinal) {
+        star.set_of_transitions.push_back({state, Epsilon, 0});
       }
-      if (!other.isStateInitial(etat_other)) {
-        all_initial = false;
+    } else if (s.second.isFinal) {
+      for (auto& t : transitions) {
+        star.set_of_transitions.push_back({state, t.first, t.second});
       }
     }
-    if (all_initial == true && nb_etat == nb_etats_initiaux) {
-      deterministic_automaton.setStateInitial(ligne.nouvel_etat);
+  }
+
+  if (!with_epsilon) {
+    for (auto& t : transitions) {
+      star.set_of_transitions.push_back({0, t.first, t.second});
+    }
+    // Un état final peut déjà avoir l'une des transitions copiées
+    removeDuplicateTransitions(star.set_of_transitions);
+  }
+  star.invalidate();
+
+  // On renvoie un automate valide
+  if (star.countSymbols() == 0) {
+    star.addSymbol('a');
+  }
+  FA_STATS_RESULT(star);
+
+  return star;
+}
+
+/**
+ * Create a deterministic automaton, if not already deterministic
+ */
+Automaton Automaton::createDeterministic(const Automaton& other) {
+  return createDeterministic(other, ConstructionOptions()).automaton;
+}
+
+/**
+ * Create a deterministic automaton, with a budget of states
+ *
+ * The construction stops when it would exceed options.max_states states
+ * or when options.cancel becomes true.
+ */
+ConstructionResult Automaton::createDeterministic(
+    const Automaton& other, const ConstructionOptions& options) {
+  FA_STATS_SCOPE("createDeterministic");
+  if (other.isDeterministic()) {
+    if (options.max_states != 0 && other.countStates() > options.max_states) {
+      return {ConstructionStatus::BudgetExceeded,
+              Automaton(other.getResource())};
+    }
+    // Copie dans la ressource mémoire de l'automate
+    Automaton copy(other.getResource());
+    copy = other;
+    return {ConstructionStatus::Completed, std::move(copy)};
+  }
+
+  // Numérotation dense des états et des symboles
+  std::vector<int> states;
+  for (const auto& s : other.set_of_states) {
+    states.push_back(s.first);
+  }
+  auto index_of = [&](int state) {
+    return std::lower_bound(states.begin(), states.end(), state) -
+           states.begin();
+  };
+  std::vector<char> alphabet_tab(other.alphabet.begin(), other.alphabet.end());
+  int symbol_index[256];
+  std::fill(std::begin(symbol_index), std::end(symbol_index), -1);
+  for (std::size_t a = 0; a < alphabet_tab.size(); a++) {
+    symbol_index[static_cast<unsigned char>(alphabet_tab[a])] = a;
+  }
+
+  // Successeurs de chaque état : (indice du symbole, indice de l'arrivée)
+  std::vector<std::vector<std::pair<int, int>>> successors(states.size());
+  for (auto& t : other.set_of_transitions) {
+    if (t.symbol == fa::Epsilon ||
+        symbol_index[static_cast<unsigned char>(t.symbol)] < 0 ||
+        !other.hasState(t.from) || !other.hasState(t.to)) {
+      continue;
+    }
+    successors[index_of(t.from)].push_back(
+        {symbol_index[static_cast<unsigned char>(t.symbol)], index_of(t.to)});
+  }
+
+  // Hachage d'un macro-état (ensemble trié d'indices d'états)
+  struct MacrostateHash {
+    std::size_t operator()(const std::vector<int>& macrostate) const {
+      std::size_t hash = macrostate.size();
+      for (int s : macrostate) {
+        hash ^= std::hash<int>()(s) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      }
+      return hash;
+    }
+  };
+
+  // Macro-états numérotés par ordre de découverte, l'initial en premier
+  std::vector<std::vector<int>> macrostates;
+  std::unordered_map<std::vector<int>, int, MacrostateHash> numbers;
+  std::vector<int> initial;
+  for (std::size_t s = 0; s < states.size(); s++) {
+    if (other.isStateInitial(states[s])) {
+      initial.push_back(s);
     }
   }
+  macrostates.push_back(initial);
+  numbers.insert({initial, 0});
+
+  Automaton deterministic_automaton(other.getResource());
+  for (char a : alphabet_tab) {
+    deterministic_automaton.addSymbol(a);
+  }
+
+  std::vector<std::vector<int>> targets(alphabet_tab.size());
+  for (std::size_t current = 0; current < macrostates.size(); current++) {
+    FA_STATS_ADD(macrostates_explored, 1);
+    for (auto& target : targets) {
+      target.clear();
+    }
+    for (int s : macrostates[current]) {
+      for (auto& successor : successors[s]) {
+        targets[successor.first].push_back(successor.second);
+      }
+    }
 
-  // Ajout des transitions
-  for (auto& transition : table_determinisme) {
-    int state_from = 0;
-    int state_to = 0;
-    for (auto& state : table_correspondance) {
-      if (transition.etat_depart == state.ensemble_etats) {
-        state_from = state.nouvel_etat;
+    for (std::size_t a = 0; a < alphabet_tab.size(); a++) {
+      std::vector<int>& target = targets[a];
+      std::sort(target.begin(), target.end());
+      target.erase(std::unique(target.begin(), target.end()), target.end());
+
+      auto it = numbers.find(target);
+      if (it == numbers.end()) {
+#ifdef FA_STATS
+        // Les macro-états déjà présents dans l'alvéole sont en collision
+        FA_STATS_ADD(hash_collisions, numbers.bucket_size(numbers.bucket(target)));
+#endif
+        it = numbers.insert({target, static_cast<int>(macrostates.size())})
+                 .first;
+        macrostates.push_back(target);
       }
-      if (transition.etat_arrivee == state.ensemble_etats) {
-        state_to = state.nouvel_etat;
+      deterministic_automaton.set_of_transitions.push_back(
+          {static_cast<int>(current), alphabet_tab[a], it->second});
+    }
+
+    ConstructionStatus status =
+        check_construction(options, current + 1, macrostates.size());
+    if (status != ConstructionStatus::Completed) {
+      return {status, Automaton(other.getResource())};
+    }
+  }
+
+  // Ajout des états : final si l'un des états de l'ensemble est final
+  for (std::size_t m = 0; m < macrostates.size(); m++) {
+    deterministic_automaton.addState(m);
+    for (int s : macrostates[m]) {
+      if (other.isStateFinal(states[s])) {
+        deterministic_automaton.setStateFinal(m);
+        break;
       }
     }
-    deterministic_automaton.addTransition(state_from, transition.symbol,
-                                          state_to);
   }
+  deterministic_automaton.setStateInitial(0);
 
-  return deterministic_automaton;
+  FA_STATS_RESULT(deterministic_automaton);
+  return {ConstructionStatus::Completed, std::move(deterministic_automaton)};
 }
 
 /**
  * Create an equivalent minimal automaton with the Moore algorithm
+ *
+ * The result is compact.
  */
 Automaton Automaton::createMinimalMoore(const Automaton& other) {
+  FA_STATS_SCOPE("createMinimalMoore");
   Automaton deterministic = createDeterministic(other);
   Automaton complete = createComplete(deterministic);
 
   if (complete.countStates() <= 1) {
+    complete.compact();
     return complete;
   }
 
@@ -1001,7 +2283,7 @@ Automaton Automaton::createMinimalMoore(const Automaton& other) {
   std::set<int> final_states;
   std::set<int> non_final_states;
 
-  for (auto& state_pair : complete.set_of_states) {
+  for (const auto& state_pair : complete.set_of_states) {
     int state = state_pair.first;
     if (complete.isStateFinal(state)) {
       final_states.insert(state);
@@ -1022,6 +2304,7 @@ Automaton Automaton::createMinimalMoore(const Automaton& other) {
 
   while (changed) {
     changed = false;
+    FA_STATS_ADD(refinement_rounds, 1);
     std::vector<std::set<int>> new_partitions;
 
     for (auto& partition : partitions) {
@@ -1060,7 +2343,7 @@ Automaton Automaton::createMinimalMoore(const Automaton& other) {
     partitions = new_partitions;
   }
 
-  Automaton minimal;
+  Automaton minimal(other.getResource());
 
   for (char symbol : complete.alphabet) {
     minimal.addSymbol(symbol);
@@ -1090,6 +2373,263 @@ Automaton Automaton::createMinimalMoore(const Automaton& other) {
     }
   }
 
+  minimal.compact();
+  FA_STATS_RESULT(minimal);
+  return minimal;
+}
+
+/**
+ * Découpe l'intervalle [0, count) en au plus nb_ranges tranches contiguës
+ * d'au moins min_size éléments
+ */
+static std::vector<std::size_t> split_ranges(std::size_t count,
+                                             std::size_t nb_ranges,
+                                             std::size_t min_size) {
+  std::size_t max_ranges = std::max<std::size_t>(1, count / min_size);
+  nb_ranges = std::max<std::size_t>(1, std::min(nb_ranges, max_ranges));
+
+  std::vector<std::size_t> bounds;
+  for (std::size_t i = 0; i <= nb_ranges; i++) {
+    bounds.push_back(count * i / nb_ranges);
+  }
+  return bounds;
+}
+
+//Structure d'un groupe de threads créés une fois et réutilisés pour chaque lot de tâches
+class WorkerPool {
+public:
+  /**
+   * Permet de créer les threads, le thread appelant travaillant aussi
+   */
+  explicit WorkerPool(std::size_t nb_workers) {
+    for (std::size_t i = 0; i < nb_workers; i++) {
+      threads.emplace_back([this]() { work(); });
+    }
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  /**
+   * Permet d'exécuter task(0), ..., task(nb_tasks - 1) et d'attendre leur fin
+   */
+  void run(std::size_t nb, const std::function<void(std::size_t)>& task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    current = &task;
+    nb_tasks = nb;
+    next_task = 0;
+    nb_finished = 0;
+    round++;
+    wake.notify_all();
+    process(lock);
+    done.wait(lock, [&]() { return nb_finished == nb_tasks; });
+  }
+
+private:
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable wake; // un nouveau lot est disponible
+  std::condition_variable done; // toutes les tâches du lot sont finies
+  const std::function<void(std::size_t)>* current = nullptr;
+  std::size_t nb_tasks = 0;
+  std::size_t next_task = 0;
+  std::size_t nb_finished = 0;
+  std::size_t round = 0; // numéro du lot courant
+  bool stopping = false;
+
+  /**
+   * Permet de prendre les tâches restantes du lot courant, verrou tenu
+   */
+  void process(std::unique_lock<std::mutex>& lock) {
+    while (next_task < nb_tasks) {
+      std::size_t i = next_task++;
+      const std::function<void(std::size_t)>& task = *current;
+      lock.unlock();
+      task(i);
+      lock.lock();
+      if (++nb_finished == nb_tasks) {
+        done.notify_all();
+      }
+    }
+  }
+
+  /**
+   * Permet à un thread d'attendre les lots et de les traiter
+   */
+  void work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    std::size_t seen_round = 0;
+    while (true) {
+      wake.wait(lock, [&]() { return stopping || round != seen_round; });
+      if (stopping) {
+        return;
+      }
+      seen_round = round;
+      process(lock);
+    }
+  }
+};
+
+/**
+ * Create an equivalent minimal automaton with the Moore algorithm,
+ * computing the signatures of each refinement round on several threads
+ *
+ * If nb_threads is 0, the number of hardware threads is used.
+ * The result is compact.
+ */
+Automaton Automaton::createMinimalMooreParallel(const Automaton& other,
+                                                std::size_t nb_threads) {
+  FA_STATS_SCOPE("createMinimalMooreParallel");
+  // En dessous de ce nombre d'états par thread, le coût de création des
+  // threads dépasse le gain
+  const std::size_t min_states_per_thread = 1024;
+
+  Automaton deterministic = createDeterministic(other);
+  Automaton complete = createComplete(deterministic);
+
+  if (complete.countStates() <= 1) {
+    complete.compact();
+    return complete;
+  }
+
+  if (nb_threads == 0) {
+    nb_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // Numérotation dense des états : le numéro d'un état est son indice
+  complete.compact();
+  std::size_t nb_states = complete.countStates();
+
+  int symbol_index[256];
+  std::fill(std::begin(symbol_index), std::end(symbol_index), -1);
+  std::vector<char> symbols;
+  for (char symbol : complete.alphabet) {
+    symbol_index[static_cast<unsigned char>(symbol)] = symbols.size();
+    symbols.push_back(symbol);
+  }
+  std::size_t nb_symbols = symbols.size();
+
+  // Table de transition plate : delta[s * nb_symbols + a]
+  std::vector<int> delta(nb_states * nb_symbols, 0);
+  for (auto& t : complete.set_of_transitions) {
+    int a = symbol_index[static_cast<unsigned char>(t.symbol)];
+    if (a < 0) {
+      continue;
+    }
+    delta[t.from * nb_symbols + a] = t.to;
+  }
+
+  // Partition initiale : états finaux / non finaux
+  std::vector<int> block(nb_states);
+  for (std::size_t s = 0; s < nb_states; s++) {
+    block[s] = complete.isStateFinal(s) ? 0 : 1;
+  }
+
+  std::size_t width = nb_symbols + 1;
+  std::vector<int> signatures(nb_states * width);
+  std::vector<int> order(nb_states);
+  std::vector<std::size_t> bounds =
+      split_ranges(nb_states, nb_threads, min_states_per_thread);
+  std::size_t nb_ranges = bounds.size() - 1;
+  WorkerPool pool(nb_ranges - 1);
+
+  auto signature_less = [&](int s1, int s2) {
+    return std::lexicographical_compare(
+        signatures.begin() + s1 * width, signatures.begin() + (s1 + 1) * width,
+        signatures.begin() + s2 * width, signatures.begin() + (s2 + 1) * width);
+  };
+
+  std::size_t nb_blocks = 0;
+  while (true) {
+    FA_STATS_ADD(refinement_rounds, 1);
+    // Calcul des signatures : bloc courant puis bloc de chaque successeur
+    pool.run(nb_ranges, [&](std::size_t range) {
+      for (std::size_t s = bounds[range]; s < bounds[range + 1]; s++) {
+        int* signature = &signatures[s * width];
+        signature[0] = block[s];
+        for (std::size_t a = 0; a < nb_symbols; a++) {
+          signature[a + 1] = block[delta[s * nb_symbols + a]];
+        }
+        order[s] = s;
+      }
+    });
+
+    // Tri de chaque tranche en parallèle puis fusion deux à deux
+    pool.run(nb_ranges, [&](std::size_t range) {
+      std::sort(order.begin() + bounds[range], order.begin() + bounds[range + 1],
+                signature_less);
+    });
+
+    std::vector<std::size_t> merge_bounds = bounds;
+    while (merge_bounds.size() > 2) {
+      std::vector<std::size_t> merged;
+      for (std::size_t i = 0; i + 1 < merge_bounds.size(); i += 2) {
+        merged.push_back(merge_bounds[i]);
+      }
+      merged.push_back(merge_bounds.back());
+      // Fusion des tranches 2i et 2i + 1
+      pool.run((merge_bounds.size() - 1) / 2, [&](std::size_t i) {
+        std::inplace_merge(order.begin() + merge_bounds[2 * i],
+                           order.begin() + merge_bounds[2 * i + 1],
+                           order.begin() + merge_bounds[2 * i + 2], signature_less);
+      });
+      merge_bounds = merged;
+    }
+
+    // Renumérotation des blocs selon les signatures triées
+    std::size_t new_nb_blocks = 0;
+    for (std::size_t i = 0; i < nb_states; i++) {
+      if (i == 0 || signature_less(order[i - 1], order[i])) {
+        new_nb_blocks++;
+      }
+      block[order[i]] = new_nb_blocks - 1;
+    }
+
+    // Un raffinement ne fusionne jamais de blocs : même nombre = stable
+    if (new_nb_blocks == nb_blocks) {
+      break;
+    }
+    nb_blocks = new_nb_blocks;
+  }
+
+  Automaton minimal(other.getResource());
+
+  for (char symbol : complete.alphabet) {
+    minimal.addSymbol(symbol);
+  }
+
+  for (std::size_t b = 0; b < nb_blocks; b++) {
+    minimal.addState(b);
+  }
+
+  std::vector<bool> block_done(nb_blocks, false);
+  for (std::size_t s = 0; s < nb_states; s++) {
+    if (complete.isStateInitial(s)) {
+      minimal.setStateInitial(block[s]);
+    }
+    if (complete.isStateFinal(s)) {
+      minimal.setStateFinal(block[s]);
+    }
+    // Les états d'un même bloc ont les mêmes successeurs par bloc
+    if (!block_done[block[s]]) {
+      block_done[block[s]] = true;
+      for (std::size_t a = 0; a < nb_symbols; a++) {
+        minimal.set_of_transitions.push_back(
+            {block[s], symbols[a], block[delta[s * nb_symbols + a]]});
+      }
+    }
+  }
+
+  minimal.compact();
+  FA_STATS_RESULT(minimal);
   return minimal;
 }
 
@@ -1097,9 +2637,1264 @@ Automaton Automaton::createMinimalMoore(const Automaton& other) {
  * Create an equivalent minimal automaton with the Brzozowski algorithm
  */
 Automaton Automaton::createMinimalBrzozowski(const Automaton& other) {
-  Automaton automaton_minimal = other.createDeterministic(
-      other.createMirror(other.createDeterministic(other.createMirror(other))));
-  return automaton_minimal;
+  return createMinimalBrzozowski(other, ConstructionOptions()).automaton;
+}
+
+/**
+ * Create an equivalent minimal automaton with the Brzozowski algorithm,
+ * with a budget of states
+ *
+ * The budget applies to each of the two determinizations.
+ */
+ConstructionResult Automaton::createMinimalBrzozowski(
+    const Automaton& other, const ConstructionOptions& options) {
+  FA_STATS_SCOPE("createMinimalBrzozowski");
+  // Les automates intermédiaires sont libérés d'un coup avec l'arène
+  std::pmr::monotonic_buffer_resource arena;
+  Automaton local(&arena);
+  local = other;
+  ConstructionResult first = createDeterministic(createMirror(local), options);
+  if (first.status != ConstructionStatus::Completed) {
+    return {first.status, Automaton(other.getResource())};
+  }
+  ConstructionResult second =
+      createDeterministic(createMirror(first.automaton), options);
+  if (second.status != ConstructionStatus::Completed) {
+    return {second.status, Automaton(other.getResource())};
+  }
+
+  Automaton automaton_minimal(other.getResource());
+  automaton_minimal = second.automaton;
+  FA_STATS_RESULT(automaton_minimal);
+  return {ConstructionStatus::Completed, std::move(automaton_minimal)};
+}
+
+/**
+ * Create the Aho-Corasick automaton of a set of keywords
+ *
+ * The automaton is deterministic and complete, and accepts the words
+ * ending with one of the keywords. The failure links are compiled into
+ * the transitions. Keywords containing an invalid symbol are ignored.
+ */
+Automaton Automaton::createAhoCorasick(
+    const std::vector<std::string>& keywords) {
+  FA_STATS_SCOPE("createAhoCorasick");
+  Automaton automaton;
+
+  // Construction de l'arbre des préfixes
+  std::vector<std::map<char, int>> children(1);
+  std::vector<bool> is_final(1, false);
+  for (auto& keyword : keywords) {
+    bool valid = true;
+    for (char c : keyword) {
+      if (!isValidSymbol(c)) {
+        valid = false;
+        break;
+      }
+    }
+    if (!valid) {
+      continue;
+    }
+
+    int node = 0;
+    for (char c : keyword) {
+      automaton.alphabet.insert(c);
+      auto it = children[node].find(c);
+      if (it == children[node].end()) {
+        children[node][c] = children.size();
+        node = children.size();
+        children.emplace_back();
+        is_final.push_back(false);
+      } else {
+        node = it->second;
+      }
+    }
+    is_final[node] = true;
+  }
+
+  // On renvoie un automate valide
+  if (automaton.alphabet.empty()) {
+    automaton.alphabet.insert('a');
+  }
+  std::vector<char> symbols(automaton.alphabet.begin(),
+                            automaton.alphabet.end());
+  std::size_t nb_symbols = symbols.size();
+
+  // Parcours en largeur : calcul des liens d'échec, intégrés à la table
+  std::vector<int> failure(children.size(), 0);
+  std::vector<int> delta(children.size() * nb_symbols, 0);
+  std::vector<int> queue = {0};
+  for (std::size_t i = 0; i < queue.size(); i++) {
+    int node = queue[i];
+    for (std::size_t a = 0; a < nb_symbols; a++) {
+      auto it = children[node].find(symbols[a]);
+      if (it == children[node].end()) {
+        delta[node * nb_symbols + a] =
+            (node == 0) ? 0 : delta[failure[node] * nb_symbols + a];
+        continue;
+      }
+      int child = it->second;
+      failure[child] = (node == 0) ? 0 : delta[failure[node] * nb_symbols + a];
+      // Un mot-clé suffixe d'un autre est reconnu avec lui
+      if (is_final[failure[child]]) {
+        is_final[child] = true;
+      }
+      delta[node * nb_symbols + a] = child;
+      queue.push_back(child);
+    }
+  }
+
+  for (std::size_t node = 0; node < children.size(); node++) {
+    automaton.addState(node);
+    if (is_final[node]) {
+      automaton.setStateFinal(node);
+    }
+  }
+  automaton.setStateInitial(0);
+
+  // Les transitions sont distinctes : ajout direct sans vérification
+  automaton.set_of_transitions.reserve(delta.size());
+  for (std::size_t node = 0; node < children.size(); node++) {
+    for (std::size_t a = 0; a < nb_symbols; a++) {
+      automaton.set_of_transitions.push_back(
+          {static_cast<int>(node), symbols[a], delta[node * nb_symbols + a]});
+    }
+  }
+  automaton.invalidate();
+  FA_STATS_RESULT(automaton);
+
+  return automaton;
+}
+
+/**
+ * Build the layout of the automaton
+ */
+FrozenAutomaton::FrozenAutomaton(const Automaton& automaton)
+    : alphabet(automaton.alphabet.begin(), automaton.alphabet.end()) {
+  for (const auto& s : automaton.set_of_states) {
+    if (s.second.isInitial) {
+      initial_indices.push_back(states.size());
+    }
+    states.push_back(s.first);
+    initial_states.push_back(s.second.isInitial);
+    final_states.push_back(s.second.isFinal);
+  }
+
+  // Tri par comptage des transitions selon leur état de départ
+  std::size_t nb_states = states.size();
+  offsets.assign(nb_states + 1, 0);
+  std::vector<std::pair<int, int>> ends; // indices de départ et d'arrivée
+  ends.reserve(automaton.set_of_transitions.size());
+  for (const auto& t : automaton.set_of_transitions) {
+    int from = index_of(t.from);
+    int to = index_of(t.to);
+    ends.push_back({from, to});
+    if (from >= 0 && to >= 0) {
+      offsets[from + 1]++;
+    }
+  }
+  for (std::size_t s = 0; s < nb_states; s++) {
+    offsets[s + 1] += offsets[s];
+  }
+
+  std::vector<std::pair<char, int>> row_entries(offsets[nb_states]);
+  std::vector<std::size_t> cursors(offsets.begin(), offsets.end() - 1);
+  for (std::size_t i = 0; i < ends.size(); i++) {
+    if (ends[i].first >= 0 && ends[i].second >= 0) {
+      row_entries[cursors[ends[i].first]++] = {
+          automaton.set_of_transitions[i].symbol, ends[i].second};
+    }
+  }
+
+  // Chaque ligne est triée par symbole puis par état d'arrivée
+  symbols.reserve(row_entries.size());
+  targets.reserve(row_entries.size());
+  for (std::size_t s = 0; s < nb_states; s++) {
+    std::sort(row_entries.begin() + offsets[s],
+              row_entries.begin() + offsets[s + 1]);
+  }
+  for (const auto& entry : row_entries) {
+    symbols.push_back(entry.first);
+    targets.push_back(entry.second);
+  }
+}
+
+/**
+ * Permet d'obtenir l'indice d'un état à partir de son numéro, ou -1
+ */
+int FrozenAutomaton::index_of(int state) const {
+  // Numérotation compacte : l'indice est le numéro
+  if (!states.empty() &&
+      states.back() == static_cast<int>(states.size()) - 1 && states[0] == 0) {
+    return (state >= 0 && state < static_cast<int>(states.size())) ? state
+                                                                    : -1;
+  }
+  auto it = std::lower_bound(states.begin(), states.end(), state);
+  if (it == states.end() || *it != state) {
+    return -1;
+  }
+  return it - states.begin();
+}
+
+/**
+ * Count the number of states
+ */
+std::size_t FrozenAutomaton::countStates() const { return states.size(); }
+
+/**
+ * Count the number of transitions
+ */
+std::size_t FrozenAutomaton::countTransitions() const {
+  return targets.size();
+}
+
+/**
+ * Tell if the automaton is deterministic
+ */
+bool FrozenAutomaton::isDeterministic() const {
+  return !findNonDeterminism().found;
+}
+
+/**
+ * Tell if the automaton is complete
+ */
+bool FrozenAutomaton::isComplete() const {
+  return !findMissingTransition().found;
+}
+
+/**
+ * Find the first reason why the automaton is not deterministic
+ *
+ * See Automaton::findNonDeterminism.
+ */
+PropertyViolation FrozenAutomaton::findNonDeterminism() const {
+  // Un état initial
+  int initial_state = -1;
+  for (std::size_t s = 0; s < states.size(); s++) {
+    if (initial_states[s]) {
+      if (initial_state >= 0) {
+        return {true, states[s], fa::Epsilon};
+      }
+      initial_state = s;
+    }
+  }
+  if (initial_state < 0) {
+    return {true, -1, fa::Epsilon};
+  }
+
+  // Les transitions d'un même symbole sont voisines dans chaque ligne
+  for (std::size_t s = 0; s < states.size(); s++) {
+    for (std::size_t k = offsets[s]; k < offsets[s + 1]; k++) {
+      if (symbols[k] == fa::Epsilon) {
+        return {true, states[s], fa::Epsilon};
+      }
+      if (k > offsets[s] && symbols[k] == symbols[k - 1] &&
+          targets[k] != targets[k - 1]) {
+        return {true, states[s], symbols[k]};
+      }
+    }
+  }
+  return {false, -1, fa::Epsilon};
+}
+
+/**
+ * Find the first state and symbol without transition
+ */
+PropertyViolation FrozenAutomaton::findMissingTransition() const {
+  // Parcours simultané de l'alphabet et de chaque ligne, tous deux triés
+  for (std::size_t s = 0; s < states.size(); s++) {
+    std::size_t k = offsets[s];
+    for (char a : alphabet) {
+      while (k < offsets[s + 1] && symbols[k] < a) {
+        k++;
+      }
+      if (k == offsets[s + 1] || symbols[k] != a) {
+        return {true, states[s], a};
+      }
+    }
+  }
+  return {false, -1, fa::Epsilon};
+}
+
+/**
+ * Check if the language of the automaton is empty
+ */
+bool FrozenAutomaton::isLanguageEmpty() const {
+  // Parcours en largeur depuis les états initiaux
+  std::vector<unsigned char> visited(states.size(), 0);
+  std::vector<int> queue;
+  for (std::size_t s = 0; s < states.size(); s++) {
+    if (initial_states[s]) {
+      visited[s] = 1;
+      queue.push_back(s);
+    }
+  }
+  for (std::size_t head = 0; head < queue.size(); head++) {
+    int s = queue[head];
+    if (final_states[s]) {
+      return false;
+    }
+    for (std::size_t k = offsets[s]; k < offsets[s + 1]; k++) {
+      if (!visited[targets[k]]) {
+        visited[targets[k]] = 1;
+        queue.push_back(targets[k]);
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Permet d'ajouter à next les successeurs des états de current par un symbole
+ */
+void FrozenAutomaton::move(const std::vector<int>& current, char symbol,
+                           std::vector<int>& next) const {
+  for (int s : current) {
+    auto first = symbols.begin() + offsets[s];
+    auto last = symbols.begin() + offsets[s + 1];
+    auto range = std::equal_range(first, last, symbol);
+    for (auto it = range.first; it != range.second; ++it) {
+      next.push_back(targets[it - symbols.begin()]);
+    }
+  }
+  // Tri des seuls successeurs : le coût ne dépend pas du nombre d'états
+  std::sort(next.begin(), next.end());
+  next.erase(std::unique(next.begin(), next.end()), next.end());
+}
+
+/**
+ * Tell if every state is accessible and co-accessible
+ */
+bool FrozenAutomaton::isTrimmed() const {
+  std::size_t nb_states = states.size();
+
+  // Parcours en avant depuis les états initiaux
+  std::vector<unsigned char> accessible(nb_states, 0);
+  std::vector<int> queue;
+  for (std::size_t s = 0; s < nb_states; s++) {
+    if (initial_states[s]) {
+      accessible[s] = 1;
+      queue.push_back(s);
+    }
+  }
+  for (std::size_t head = 0; head < queue.size(); head++) {
+    int s = queue[head];
+    for (std::size_t k = offsets[s]; k < offsets[s + 1]; k++) {
+      if (!accessible[targets[k]]) {
+        accessible[targets[k]] = 1;
+        queue.push_back(targets[k]);
+      }
+    }
+  }
+  if (queue.size() != nb_states) {
+    return false;
+  }
+
+  // Parcours en arrière depuis les états finaux, sur les transitions inversées
+  std::vector<std::size_t> reverse_offsets(nb_states + 1, 0);
+  for (int to : targets) {
+    reverse_offsets[to + 1]++;
+  }
+  for (std::size_t s = 0; s < nb_states; s++) {
+    reverse_offsets[s + 1] += reverse_offsets[s];
+  }
+  std::vector<int> sources(targets.size());
+  std::vector<std::size_t> cursors(reverse_offsets.begin(),
+                                   reverse_offsets.end() - 1);
+  for (std::size_t s = 0; s < nb_states; s++) {
+    for (std::size_t k = offsets[s]; k < offsets[s + 1]; k++) {
+      sources[cursors[targets[k]]++] = s;
+    }
+  }
+
+  std::vector<unsigned char> co_accessible(nb_states, 0);
+  queue.clear();
+  for (std::size_t s = 0; s < nb_states; s++) {
+    if (final_states[s]) {
+      co_accessible[s] = 1;
+      queue.push_back(s);
+    }
+  }
+  for (std::size_t head = 0; head < queue.size(); head++) {
+    int s = queue[head];
+    for (std::size_t k = reverse_offsets[s]; k < reverse_offsets[s + 1]; k++) {
+      if (!co_accessible[sources[k]]) {
+        co_accessible[sources[k]] = 1;
+        queue.push_back(sources[k]);
+      }
+    }
+  }
+  return queue.size() == nb_states;
+}
+
+/**
+ * Read the string and compute the state set after traversing the automaton
+ */
+std::set<int> FrozenAutomaton::readString(const std::string& word) const {
+  std::vector<int> current = initial_indices;
+  std::vector<int> next;
+  for (char c : word) {
+    next.clear();
+    move(current, c, next);
+    current.swap(next);
+  }
+
+  std::set<int> result;
+  for (int s : current) {
+    result.insert(states[s]);
+  }
+  return result;
+}
+
+/**
+ * Tell if the word is in the language accepted by the automaton
+ */
+bool FrozenAutomaton::match(const std::string& word) const {
+  std::vector<int> current = initial_indices;
+  std::vector<int> next;
+  for (char c : word) {
+    next.clear();
+    move(current, c, next);
+    current.swap(next);
+    if (current.empty()) {
+      return false;
+    }
+  }
+  for (int s : current) {
+    if (final_states[s]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Compile the automaton
+ *
+ * If the automaton has more than MaxStates states, the result is not valid.
+ */
+BitParallelAutomaton::BitParallelAutomaton(const Automaton& automaton)
+    : valid(false), nb_groups(0), initial_states(0), final_states(0) {
+  std::fill(std::begin(symbol_index), std::end(symbol_index), -1);
+  if (automaton.countStates() > MaxStates) {
+    return;
+  }
+  valid = true;
+
+  // Attribution d'un bit à chaque état
+  std::map<int, int> state_bit;
+  for (const auto& s : automaton.set_of_states) {
+    state_bit[s.first] = states.size();
+    if (s.second.isInitial) {
+      initial_states |= std::uint64_t(1) << states.size();
+    }
+    if (s.second.isFinal) {
+      final_states |= std::uint64_t(1) << states.size();
+    }
+    states.push_back(s.first);
+  }
+  nb_groups = (states.size() + 3) / 4;
+
+  int nb_symbols = 0;
+  for (char symbol : automaton.alphabet) {
+    symbol_index[static_cast<unsigned char>(symbol)] = nb_symbols;
+    nb_symbols++;
+  }
+
+  // Successeurs de chaque état pour chaque symbole
+  std::vector<std::uint64_t> successors(nb_symbols * states.size(), 0);
+  for (auto& t : automaton.set_of_transitions) {
+    if (t.symbol == Epsilon) {
+      continue;
+    }
+    // Symbole hors de l'alphabet : la transition ne peut pas être lue
+    int a = symbol_index[static_cast<unsigned char>(t.symbol)];
+    if (a < 0) {
+      continue;
+    }
+    successors[a * states.size() + state_bit[t.from]] |= std::uint64_t(1)
+                                                         << state_bit[t.to];
+  }
+
+  // Successeurs de chaque sous-ensemble d'un groupe de 4 états : celui du
+  // sous-ensemble privé de son bit de poids faible, plus ceux de ce bit
+  table.assign(nb_symbols * nb_groups * 16, 0);
+  for (int a = 0; a < nb_symbols; a++) {
+    for (std::size_t g = 0; g < nb_groups; g++) {
+      std::uint64_t* group_table = &table[(a * nb_groups + g) * 16];
+      for (int subset = 1; subset < 16; subset++) {
+        int low_bit = 0;
+        while (!(subset & (1 << low_bit))) {
+          low_bit++;
+        }
+        std::size_t state = g * 4 + low_bit;
+        std::uint64_t state_successors =
+            state < states.size() ? successors[a * states.size() + state] : 0;
+        group_table[subset] =
+            group_table[subset & (subset - 1)] | state_successors;
+      }
+    }
+  }
+}
+
+/**
+ * Tell if the automaton could be compiled
+ */
+bool BitParallelAutomaton::isValid() const { return valid; }
+
+/**
+ * Permet d'obtenir l'ensemble d'états atteint après lecture du mot
+ */
+std::uint64_t BitParallelAutomaton::read(const std::string& word) const {
+  std::uint64_t current = initial_states;
+  for (char c : word) {
+    int a = symbol_index[static_cast<unsigned char>(c)];
+    if (a < 0 || current == 0) {
+      return 0;
+    }
+    const std::uint64_t* symbol_table = &table[a * nb_groups * 16];
+    std::uint64_t next = 0;
+    for (std::size_t g = 0; g < nb_groups; g++) {
+      next |= symbol_table[g * 16 + ((current >> (g * 4)) & 0xF)];
+    }
+    current = next;
+  }
+  return current;
+}
+
+/**
+ * Read the string and compute the state set after traversing the automaton
+ */
+std::set<int> BitParallelAutomaton::readString(const std::string& word) const {
+  std::set<int> result;
+  std::uint64_t current = read(word);
+  for (std::size_t i = 0; i < states.size(); i++) {
+    if (current & (std::uint64_t(1) << i)) {
+      result.insert(states[i]);
+    }
+  }
+  return result;
+}
+
+/**
+ * Tell if the word is in the language accepted by the automaton
+ */
+bool BitParallelAutomaton::match(const std::string& word) const {
+  return (read(word) & final_states) != 0;
+}
+
+/**
+ * Prepare the automaton, with at most max_cached_states macrostates in cache
+ *
+ * max_flushes is the number of flushes allowed while reading a word
+ * before falling back to the simulation of the original automaton.
+ */
+LazyDeterministicAutomaton::LazyDeterministicAutomaton(
+    const Automaton& automaton, std::size_t max_cached_states,
+    std::size_t max_flushes)
+    : nb_symbols(automaton.countSymbols()),
+      max_cached_states(std::max<std::size_t>(2, max_cached_states)),
+      max_flushes(max_flushes),
+      nb_flushes(0) {
+  std::fill(std::begin(symbol_index), std::end(symbol_index), -1);
+  int a = 0;
+  for (char symbol : automaton.alphabet) {
+    symbol_index[static_cast<unsigned char>(symbol)] = a;
+    a++;
+  }
+
+  // Numérotation dense des états
+  std::map<int, int> state_index;
+  for (const auto& s : automaton.set_of_states) {
+    int index = final_states.size();
+    state_index[s.first] = index;
+    final_states.push_back(s.second.isFinal);
+    if (s.second.isInitial) {
+      initial_macrostate.push_back(index);
+    }
+  }
+
+  successors.resize(final_states.size() * nb_symbols);
+  for (auto& t : automaton.set_of_transitions) {
+    // Symbole hors de l'alphabet : la transition ne peut pas être lue
+    int symbol = symbol_index[static_cast<unsigned char>(t.symbol)];
+    if (t.symbol == Epsilon || symbol < 0) {
+      continue;
+    }
+    successors[state_index[t.from] * nb_symbols + symbol].push_back(
+        state_index[t.to]);
+  }
+}
+
+/**
+ * Permet d'obtenir le numéro d'un macro-état, en l'ajoutant au cache si besoin
+ */
+int LazyDeterministicAutomaton::find_macrostate(
+    const std::vector<int>& macrostate) {
+  auto it = macrostate_numbers.find(macrostate);
+  if (it != macrostate_numbers.end()) {
+    return it->second;
+  }
+
+  int number = macrostates.size();
+  macrostate_numbers.insert({macrostate, number});
+  macrostates.push_back(macrostate);
+  bool is_final = false;
+  for (int state : macrostate) {
+    if (final_states[state]) {
+      is_final = true;
+      break;
+    }
+  }
+  macrostate_final.push_back(is_final);
+  cached_transitions.resize(macrostates.size() * nb_symbols, -1);
+  return number;
+}
+
+/**
+ * Permet d'obtenir les états accessibles depuis un macro-état grâce à un
+ * symbole
+ */
+std::vector<int> LazyDeterministicAutomaton::move(
+    const std::vector<int>& macrostate, int symbol) const {
+  std::vector<int> result;
+  for (int state : macrostate) {
+    const std::vector<int>& targets = successors[state * nb_symbols + symbol];
+    result.insert(result.end(), targets.begin(), targets.end());
+  }
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+/**
+ * Permet de vider le cache
+ */
+void LazyDeterministicAutomaton::flush() {
+  macrostate_numbers.clear();
+  macrostates.clear();
+  macrostate_final.clear();
+  cached_transitions.clear();
+  nb_flushes++;
+}
+
+/**
+ * Tell if the word is in the language accepted by the automaton
+ */
+bool LazyDeterministicAutomaton::match(const std::string& word) {
+  if (macrostates.size() >= max_cached_states &&
+      macrostate_numbers.find(initial_macrostate) == macrostate_numbers.end()) {
+    flush();
+  }
+  int current = find_macrostate(initial_macrostate);
+  std::size_t nb_flushes_word = 0;
+
+  for (std::size_t i = 0; i < word.length(); i++) {
+    int a = symbol_index[static_cast<unsigned char>(word[i])];
+    if (a < 0 || macrostates[current].empty()) {
+      return false;
+    }
+
+    int next = cached_transitions[current * nb_symbols + a];
+    if (next < 0) {
+      std::vector<int> target = move(macrostates[current], a);
+
+      // Cache plein : on le vide en conservant le macro-état courant
+      if (macrostates.size() >= max_cached_states &&
+          macrostate_numbers.find(target) == macrostate_numbers.end()) {
+        std::vector<int> current_macrostate = macrostates[current];
+        flush();
+        nb_flushes_word++;
+
+        // Le cache ne sert plus à rien : simulation de l'automate d'origine
+        if (nb_flushes_word > max_flushes) {
+          for (i++; i < word.length() && !target.empty(); i++) {
+            a = symbol_index[static_cast<unsigned char>(word[i])];
+            if (a < 0) {
+              return false;
+            }
+            target = move(target, a);
+          }
+          for (int state : target) {
+            if (final_states[state]) {
+              return true;
+            }
+          }
+          return false;
+        }
+
+        current = find_macrostate(current_macrostate);
+      }
+
+      next = find_macrostate(target);
+      cached_transitions[current * nb_symbols + a] = next;
+    }
+    current = next;
+  }
+
+  return macrostate_final[current];
+}
+
+/**
+ * Count the number of macrostates currently in cache
+ */
+std::size_t LazyDeterministicAutomaton::countCachedStates() const {
+  return macrostates.size();
+}
+
+/**
+ * Count the number of times the cache has been flushed
+ */
+std::size_t LazyDeterministicAutomaton::countFlushes() const {
+  return nb_flushes;
+}
+
+/**
+ * Construit, par la méthode des sous-ensembles, l'automate déterministe
+ * du langage. S'il est non ancré, il reconnait les mots se terminant par un
+ * mot du langage : les états initiaux sont ajoutés à chaque macro-état.
+ * Les transitions sont indexées par octet ([macro-état * 256 + octet]), le
+ * macro-état 0 est initial et -1 désigne l'état puits de l'automate ancré.
+ * Renvoie les ensembles d'états de chaque macro-état.
+ */
+static std::vector<std::vector<int>> build_byte_automaton(
+    const std::vector<std::vector<std::pair<unsigned char, int>>>& adjacency,
+    const std::vector<int>& initial_states,
+    const std::vector<bool>& final_states, bool unanchored,
+    std::vector<int>& transitions, std::vector<bool>& final_macrostates) {
+  std::map<std::vector<int>, int> macrostate_numbers;
+  std::vector<std::vector<int>> macrostates;
+
+  auto find_macrostate = [&](std::vector<int>& macrostate) {
+    if (unanchored || macrostates.empty()) {
+      macrostate.insert(macrostate.end(), initial_states.begin(),
+                        initial_states.end());
+    }
+    std::sort(macrostate.begin(), macrostate.end());
+    macrostate.erase(std::unique(macrostate.begin(), macrostate.end()),
+                     macrostate.end());
+    auto it = macrostate_numbers.find(macrostate);
+    if (it != macrostate_numbers.end()) {
+      return it->second;
+    }
+    int number = macrostates.size();
+    macrostate_numbers.insert({macrostate, number});
+    macrostates.push_back(macrostate);
+    bool is_final = false;
+    for (int state : macrostate) {
+      if (final_states[state]) {
+        is_final = true;
+      }
+    }
+    final_macrostates.push_back(is_final);
+    // Par défaut, un octet ramène au macro-état initial ou à l'état puits
+    transitions.resize(macrostates.size() * 256, unanchored ? 0 : -1);
+    return number;
+  };
+
+  std::vector<int> initial_macrostate;
+  find_macrostate(initial_macrostate);
+
+  for (std::size_t current = 0; current < macrostates.size(); current++) {
+    std::map<unsigned char, std::vector<int>> targets;
+    for (int state : macrostates[current]) {
+      for (auto& t : adjacency[state]) {
+        targets[t.first].push_back(t.second);
+      }
+    }
+    for (auto& target : targets) {
+      int number = find_macrostate(target.second);
+      transitions[current * 256 + target.first] = number;
+    }
+  }
+  return macrostates;
+}
+
+/**
+ * Recherche portable du prochain octet appartenant à la table
+ */
+static std::size_t scan_table(const unsigned char* text, std::size_t begin,
+                              std::size_t end, const bool* table) {
+  while (begin < end && !table[text[begin]]) {
+    begin++;
+  }
+  return begin;
+}
+
+#ifdef FA_X86_SIMD
+/**
+ * Recherche du prochain octet parmi (au plus) trois, 16 octets à la fois
+ */
+__attribute__((target("sse2"))) static std::size_t scan_sse2(
+    const unsigned char* text, std::size_t begin, std::size_t end,
+    const unsigned char* needles, const bool* table) {
+  __m128i needle0 = _mm_set1_epi8(static_cast<char>(needles[0]));
+  __m128i needle1 = _mm_set1_epi8(static_cast<char>(needles[1]));
+  __m128i needle2 = _mm_set1_epi8(static_cast<char>(needles[2]));
+  for (; begin + 16 <= end; begin += 16) {
+    __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + begin));
+    __m128i equal = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(block, needle0),
+                     _mm_cmpeq_epi8(block, needle1)),
+        _mm_cmpeq_epi8(block, needle2));
+    unsigned mask = _mm_movemask_epi8(equal);
+    if (mask != 0) {
+      return begin + __builtin_ctz(mask);
+    }
+  }
+  return scan_table(text, begin, end, table);
+}
+
+/**
+ * Recherche du prochain octet parmi (au plus) trois, 32 octets à la fois
+ */
+__attribute__((target("avx2"))) static std::size_t scan_avx2(
+    const unsigned char* text, std::size_t begin, std::size_t end,
+    const unsigned char* needles, const bool* table) {
+  __m256i needle0 = _mm256_set1_epi8(static_cast<char>(needles[0]));
+  __m256i needle1 = _mm256_set1_epi8(static_cast<char>(needles[1]));
+  __m256i needle2 = _mm256_set1_epi8(static_cast<char>(needles[2]));
+  for (; begin + 32 <= end; begin += 32) {
+    __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + begin));
+    __m256i equal = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(block, needle0),
+                        _mm256_cmpeq_epi8(block, needle1)),
+        _mm256_cmpeq_epi8(block, needle2));
+    unsigned mask = _mm256_movemask_epi8(equal);
+    if (mask != 0) {
+      return begin + __builtin_ctz(mask);
+    }
+  }
+  return scan_sse2(text, begin, end, needles, table);
+}
+
+/**
+ * Permet de savoir si le processeur supporte AVX2
+ */
+static bool cpu_supports_avx2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+#endif
+
+/**
+ * Compile the automaton
+ */
+SubstringSearcher::SubstringSearcher(const Automaton& automaton) {
+  // Numérotation dense des états
+  std::map<int, int> state_index;
+  std::vector<int> initial_states;
+  std::vector<bool> nfa_final_states;
+  for (const auto& s : automaton.set_of_states) {
+    int index = nfa_final_states.size();
+    state_index[s.first] = index;
+    nfa_final_states.push_back(s.second.isFinal);
+    if (s.second.isInitial) {
+      initial_states.push_back(index);
+    }
+  }
+
+  std::vector<std::vector<std::pair<unsigned char, int>>> adjacency(
+      nfa_final_states.size());
+  std::vector<std::vector<std::pair<unsigned char, int>>> mirror_adjacency(
+      nfa_final_states.size());
+  for (auto& t : automaton.set_of_transitions) {
+    if (t.symbol != Epsilon) {
+      unsigned char byte = static_cast<unsigned char>(t.symbol);
+      adjacency[state_index[t.from]].push_back({byte, state_index[t.to]});
+      mirror_adjacency[state_index[t.to]].push_back({byte, state_index[t.from]});
+    }
+  }
+
+  // Le miroir a pour états initiaux les états finaux, et inversement
+  std::vector<int> nfa_final_list;
+  std::vector<bool> nfa_initial_states(nfa_final_states.size(), false);
+  for (std::size_t s = 0; s < nfa_final_states.size(); s++) {
+    if (nfa_final_states[s]) {
+      nfa_final_list.push_back(s);
+    }
+  }
+  for (int s : initial_states) {
+    nfa_initial_states[s] = true;
+  }
+
+  build_byte_automaton(adjacency, initial_states, nfa_final_states, true,
+                       transitions, final_states);
+  build_byte_automaton(mirror_adjacency, nfa_final_list, nfa_initial_states,
+                       true, mirror_transitions, mirror_final_states);
+  build_byte_automaton(adjacency, initial_states, nfa_final_states, false,
+                       anchored_transitions, anchored_final_states);
+
+  // Octets faisant quitter le macro-état initial
+  for (int byte = 0; byte < 256; byte++) {
+    is_first_byte[byte] = transitions[byte] != 0;
+    if (is_first_byte[byte]) {
+      first_bytes.push_back(byte);
+    }
+  }
+}
+
+/**
+ * Permet d'obtenir la position du prochain octet pouvant débuter une
+ * correspondance, ou la fin du texte
+ */
+std::size_t SubstringSearcher::find_first_byte(std::string_view text,
+                                               std::size_t begin) const {
+  const unsigned char* data =
+      reinterpret_cast<const unsigned char*>(text.data());
+  if (first_bytes.empty()) {
+    return text.size();
+  }
+#ifdef FA_X86_SIMD
+  if (first_bytes.size() <= 3) {
+    unsigned char needles[3] = {first_bytes[0],
+                                first_bytes[(first_bytes.size() > 1) ? 1 : 0],
+                                first_bytes[first_bytes.size() - 1]};
+    if (cpu_supports_avx2()) {
+      return scan_avx2(data, begin, text.size(), needles, is_first_byte);
+    }
+    return scan_sse2(data, begin, text.size(), needles, is_first_byte);
+  }
+#endif
+  return scan_table(data, begin, text.size(), is_first_byte);
+}
+
+/**
+ * Tell if a factor of the text is in the language accepted by the automaton
+ */
+bool SubstringSearcher::matchSubstring(std::string_view text) const {
+  return find_first_end(text) != std::string_view::npos;
+}
+
+/**
+ * Permet d'obtenir la fin de la première correspondance, ou npos
+ */
+std::size_t SubstringSearcher::find_first_end(std::string_view text) const {
+  if (final_states[0]) {
+    return 0;
+  }
+
+  int state = 0;
+  for (std::size_t i = 0; i < text.size(); i++) {
+    // Aucune correspondance en cours : saut jusqu'à un octet utile
+    if (state == 0) {
+      i = find_first_byte(text, i);
+      if (i == text.size()) {
+        return std::string_view::npos;
+      }
+    }
+    state = transitions[state * 256 + static_cast<unsigned char>(text[i])];
+    if (final_states[state]) {
+      return i + 1;
+    }
+  }
+  return std::string_view::npos;
+}
+
+/**
+ * Find the leftmost-longest factor of the text in the language
+ *
+ * The leftmost start is found by reading the text backwards with the
+ * automaton of the mirror language, then the longest end by reading
+ * forward from this start.
+ */
+SearchResult SubstringSearcher::search(std::string_view text) const {
+  SearchResult result = {false, 0, 0};
+  if (find_first_end(text) == std::string_view::npos) {
+    return result;
+  }
+  result.found = true;
+
+  // Début le plus à gauche : lecture à l'envers du texte par le miroir
+  int state = 0;
+  result.start = text.size();
+  for (std::size_t i = text.size(); i > 0; i--) {
+    state = mirror_transitions[state * 256 +
+                               static_cast<unsigned char>(text[i - 1])];
+    if (mirror_final_states[state]) {
+      result.start = i - 1;
+    }
+  }
+
+  // Fin la plus à droite depuis ce début
+  state = 0;
+  result.end = result.start;
+  for (std::size_t i = result.start; i < text.size(); i++) {
+    state = anchored_transitions[state * 256 +
+                                 static_cast<unsigned char>(text[i])];
+    if (state < 0) {
+      break;
+    }
+    if (anchored_final_states[state]) {
+      result.end = i + 1;
+    }
+  }
+  return result;
+}
+
+/**
+ * Count the number of bytes that can start a non-empty match
+ */
+std::size_t SubstringSearcher::countFirstBytes() const {
+  return first_bytes.size();
+}
+
+/**
+ * Merge the patterns into a single deterministic automaton
+ */
+MultiPatternAutomaton::MultiPatternAutomaton(
+    const std::vector<Automaton>& patterns)
+    : nb_patterns(patterns.size()), nb_words((patterns.size() + 63) / 64) {
+  // Union disjointe des patrons, en retenant le patron de chaque état
+  std::vector<std::vector<std::pair<unsigned char, int>>> adjacency;
+  std::vector<int> initial_states;
+  std::vector<bool> final_states;
+  std::vector<std::size_t> state_pattern;
+
+  for (std::size_t p = 0; p < patterns.size(); p++) {
+    std::map<int, int> state_index;
+    for (const auto& s : patterns[p].set_of_states) {
+      int index = final_states.size();
+      state_index[s.first] = index;
+      final_states.push_back(s.second.isFinal);
+      state_pattern.push_back(p);
+      if (s.second.isInitial) {
+        initial_states.push_back(index);
+      }
+    }
+    adjacency.resize(final_states.size());
+    for (auto& t : patterns[p].set_of_transitions) {
+      if (t.symbol != Epsilon) {
+        adjacency[state_index[t.from]].push_back(
+            {static_cast<unsigned char>(t.symbol), state_index[t.to]});
+      }
+    }
+  }
+
+  std::vector<bool> final_macrostates;
+  std::vector<std::vector<int>> macrostates =
+      build_byte_automaton(adjacency, initial_states, final_states, false,
+                           transitions, final_macrostates);
+
+  // Patrons reconnus dans chaque macro-état
+  pattern_bits.assign(macrostates.size() * nb_words, 0);
+  for (std::size_t m = 0; m < macrostates.size(); m++) {
+    for (int state : macrostates[m]) {
+      if (final_states[state]) {
+        std::size_t p = state_pattern[state];
+        pattern_bits[m * nb_words + p / 64] |= std::uint64_t(1) << (p % 64);
+      }
+    }
+  }
+}
+
+/**
+ * Compute the indices of the patterns accepting the word, in increasing order
+ */
+std::vector<std::size_t> MultiPatternAutomaton::match(
+    const std::string& word) const {
+  std::vector<std::size_t> matching_patterns;
+  int state = 0;
+  for (char c : word) {
+    state = transitions[state * 256 + static_cast<unsigned char>(c)];
+    if (state < 0) {
+      return matching_patterns;
+    }
+  }
+
+  for (std::size_t w = 0; w < nb_words; w++) {
+    std::uint64_t bits = pattern_bits[state * nb_words + w];
+    while (bits != 0) {
+      matching_patterns.push_back(w * 64 + __builtin_ctzll(bits));
+      bits &= bits - 1;
+    }
+  }
+  return matching_patterns;
+}
+
+/**
+ * Count the number of patterns
+ */
+std::size_t MultiPatternAutomaton::countPatterns() const { return nb_patterns; }
+
+/**
+ * Count the number of states of the merged automaton
+ */
+std::size_t MultiPatternAutomaton::countStates() const {
+  return transitions.size() / 256;
+}
+
+/**
+ * Build an empty builder (empty language)
+ */
+MinimalAcyclicBuilder::MinimalAcyclicBuilder() : has_word(false) {
+  nodes.push_back({false, {}});
+  path.push_back(0);
+}
+
+/**
+ * Permet de créer un nouvel état, en réutilisant un état libéré si possible
+ */
+int MinimalAcyclicBuilder::new_node() {
+  if (!free_nodes.empty()) {
+    int node = free_nodes.back();
+    free_nodes.pop_back();
+    nodes[node] = {false, {}};
+    return node;
+  }
+  nodes.push_back({false, {}});
+  return nodes.size() - 1;
+}
+
+/**
+ * Permet de calculer l'empreinte d'un état : finalité et transitions
+ */
+std::size_t MinimalAcyclicBuilder::node_hash(const Node& node) {
+  std::size_t hash = node.isFinal ? 1 : 0;
+  for (auto& t : node.transitions) {
+    hash ^= std::hash<int>()(static_cast<unsigned char>(t.first)) + 0x9e3779b9 +
+            (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>()(t.second) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+/**
+ * Permet de trouver un état du registre de même finalité et de mêmes
+ * transitions, renvoie -1 si aucun
+ */
+int MinimalAcyclicBuilder::find_registered(const Node& node) const {
+  auto [begin, end] = register_of_states.equal_range(node_hash(node));
+  for (auto it = begin; it != end; ++it) {
+    const Node& registered = nodes[it->second];
+    if (registered.isFinal == node.isFinal &&
+        registered.transitions == node.transitions) {
+      return it->second;
+    }
+  }
+  return -1;
+}
+
+/**
+ * Permet de remplacer les états du chemin du dernier mot au-delà de la
+ * longueur donnée par un équivalent du registre, ou de les y ajouter
+ */
+void MinimalAcyclicBuilder::replace_or_register(std::size_t length) {
+  // Du bout du chemin vers sa racine : les fils sont traités avant le père
+  while (path.size() > length + 1) {
+    int child = path.back();
+    path.pop_back();
+    int parent = path.back();
+
+    // Le registre ne garde que les numéros d'états, pas leurs transitions
+    int registered = find_registered(nodes[child]);
+    if (registered >= 0) {
+      nodes[parent].transitions.back().second = registered;
+      nodes[child].transitions.clear();
+      free_nodes.push_back(child);
+    } else {
+      register_of_states.insert({node_hash(nodes[child]), child});
+    }
+  }
+}
+
+/**
+ * Add a word
+ *
+ * Returns true if the word was effectively added, and false if it is not
+ * greater than the previously added word or contains an invalid symbol.
+ */
+bool MinimalAcyclicBuilder::addWord(const std::string& word) {
+  if (has_word && word <= last_word) {
+    return false;
+  }
+  for (char c : word) {
+    if (!Automaton::isValidSymbol(c)) {
+      return false;
+    }
+  }
+
+  // Plus long préfixe commun avec le mot précédent
+  std::size_t prefix = 0;
+  while (prefix < word.size() && prefix < last_word.size() &&
+         word[prefix] == last_word[prefix]) {
+    prefix++;
+  }
+
+  replace_or_register(prefix);
+
+  // Ajout du suffixe restant
+  for (std::size_t i = prefix; i < word.size(); i++) {
+    int node = new_node();
+    nodes[path.back()].transitions.push_back({word[i], node});
+    path.push_back(node);
+  }
+  nodes[path.back()].isFinal = true;
+
+  last_word = word;
+  has_word = true;
+  return true;
+}
+
+/**
+ * Count the number of states currently used
+ */
+std::size_t MinimalAcyclicBuilder::countStates() const {
+  return nodes.size() - free_nodes.size();
+}
+
+/**
+ * Create the minimal deterministic automaton accepting the added words
+ *
+ * The automaton is trimmed, thus not complete.
+ */
+Automaton MinimalAcyclicBuilder::createAutomaton() const {
+  // Les états du chemin du dernier mot ne sont pas encore dans le registre :
+  // leurs équivalents sont cherchés sans modifier le constructeur
+  std::vector<int> representatives(nodes.size(), -1);
+  auto target_of = [&](int node) {
+    return representatives[node] >= 0 ? representatives[node] : node;
+  };
+  for (std::size_t k = path.size() - 1; k >= 1; k--) {
+    Node candidate = nodes[path[k]];
+    if (k + 1 < path.size()) {
+      candidate.transitions.back().second = target_of(path[k + 1]);
+    }
+    int registered = find_registered(candidate);
+    representatives[path[k]] = registered >= 0 ? registered : path[k];
+  }
+
+  // Numérotation des états en largeur depuis l'état initial
+  Automaton automaton;
+  std::vector<int> numbers(nodes.size(), -1);
+  std::vector<int> queue = {0};
+  numbers[0] = 0;
+  for (std::size_t i = 0; i < queue.size(); i++) {
+    const Node& node = nodes[queue[i]];
+    automaton.addState(i);
+    if (node.isFinal) {
+      automaton.setStateFinal(i);
+    }
+    for (auto& t : node.transitions) {
+      int target = target_of(t.second);
+      if (numbers[target] < 0) {
+        numbers[target] = queue.size();
+        queue.push_back(target);
+      }
+      automaton.alphabet.insert(t.first);
+      automaton.set_of_transitions.push_back(
+          {static_cast<int>(i), t.first, numbers[target]});
+    }
+  }
+  automaton.setStateInitial(0);
+
+  // On renvoie un automate valide
+  if (automaton.countSymbols() == 0) {
+    automaton.addSymbol('a');
+  }
+  return automaton;
 }
 
 }  // namespace fa
@@ -3,15 +3,23 @@
 #define AUTOMATON_H
 
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iosfwd>
+#include <iterator>
 #include<iostream>
 
 #include <string>
+#include <string_view>
 #include <utility>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <memory>
+#include <memory_resource>
 #include <vector>
 #include <algorithm>
+#include <atomic>
 
 
 namespace fa {
@@ -31,12 +39,70 @@ namespace fa {
     int to;
   };
 
+  /**
+   * Sort transitions by origin, symbol and destination, and remove the duplicates
+   *
+   * Shared by the code which adds transitions in bulk to set_of_transitions.
+   */
+  void removeDuplicateTransitions(std::pmr::vector<Transition>& transitions);
+
   //Structure reliant un ensemble d'état à son nouvel état
   struct Correspondance {
     int nouvel_etat;
     std::set<int> ensemble_etats;
   };
 
+  //Structure décrivant l'occurrence trouvée par une recherche dans un texte
+  struct SearchResult {
+    bool found;
+    std::size_t start;
+    std::size_t end;
+  };
+
+  //Structure décrivant le premier défaut trouvé lors de la vérification d'une propriété
+  struct PropertyViolation {
+    bool found;  // false si la propriété est vérifiée
+    int state;   // état en cause, -1 si le défaut ne concerne pas un état
+    char symbol; // symbole en cause, Epsilon si aucun
+  };
+
+  //Structure des statistiques d'une opération, collectées si FA_STATS est défini
+  struct OperationStats {
+    std::size_t states_created;      // états des automates construits
+    std::size_t transitions_created; // transitions des automates construits
+    std::size_t macrostates_explored; // ensembles ou couples d'états explorés
+    std::size_t refinement_rounds;   // tours de raffinement de la minimisation
+    std::size_t hash_collisions;     // macro-états partageant une alvéole
+    std::size_t bytes_allocated;     // estimé d'après la taille des conteneurs
+    double seconds;                  // temps écoulé
+  };
+
+  /**
+   * Function receiving the name and the statistics of an operation
+   */
+  using StatsCallback = std::function<void(const std::string& operation, const OperationStats& stats)>;
+
+  //Structure des options des constructions longues
+  struct ConstructionOptions {
+    std::size_t max_states = 0; // nombre maximal d'états construits, 0 pour aucune limite
+    const std::atomic<bool>* cancel = nullptr; // la construction s'arrête dès qu'il vaut true
+    std::function<void(std::size_t nb_states)> progress; // appelée avec le nombre d'états explorés
+    std::size_t progress_interval = 1024; // nombre d'états explorés entre deux appels
+  };
+
+  //Forme du code C++ généré à partir d'un automate
+  enum class CodeStyle {
+    Switch, // une boucle sur le texte, un switch sur l'état courant
+    Goto    // une étiquette par état, reliées par des goto
+  };
+
+  //Issue d'une construction longue
+  enum class ConstructionStatus {
+    Completed,
+    BudgetExceeded, // plus de max_states états
+    Cancelled       // cancel est passé à true
+  };
+
   //Structure représentant une ligne de la table de déterminisation
   struct Determinisation{
     std::set<int> etat_depart;
@@ -44,17 +110,282 @@ namespace fa {
     std::set<int> etat_arrivee;
   };
 
+  /**
+   * Storage of the states of an automaton
+   *
+   * The flags of the states are stored in a vector. While the state numbers
+   * stay small compared to the number of states, a state number is its index
+   * in the vector; otherwise, a map gives the index of each state.
+   * Iteration visits the states by increasing number. The memory comes from
+   * a polymorphic memory resource.
+   */
+  class StateTable {
+  public:
+    //Structure d'un état lors du parcours : son numéro et ses drapeaux
+    struct Entry {
+      int first;
+      struct State second;
+    };
+
+    class const_iterator {
+    public:
+      Entry operator*() const;
+      const_iterator& operator++();
+      bool operator==(const const_iterator& other) const;
+      bool operator!=(const const_iterator& other) const;
+
+    private:
+      friend class StateTable;
+      const StateTable* table;
+      std::size_t index; // position dans flags, en mode dense
+      std::pmr::map<int, std::size_t>::const_iterator position; // en mode creux
+    };
+
+    /**
+     * Build an empty table, using the default memory resource
+     */
+    StateTable();
+
+    /**
+     * Build an empty table, using the given memory resource
+     */
+    explicit StateTable(std::pmr::memory_resource* resource);
+
+    /**
+     * Count the number of states
+     */
+    std::size_t size() const;
+
+    /**
+     * Tell if there is no state
+     */
+    bool empty() const;
+
+    /**
+     * Tell if the state is present
+     */
+    bool contains(int state) const;
+
+    /**
+     * Add a state, neither initial nor final
+     *
+     * Returns true if the state was effectively added.
+     */
+    bool insert(int state);
+
+    /**
+     * Remove a state
+     *
+     * Returns true if the state was effectively removed.
+     */
+    bool erase(int state);
+
+    /**
+     * Remove all the states
+     */
+    void clear();
+
+    /**
+     * Tell if the state is present and initial
+     */
+    bool isInitial(int state) const;
+
+    /**
+     * Tell if the state is present and final
+     */
+    bool isFinal(int state) const;
+
+    /**
+     * Set the state initial, if present
+     */
+    void setInitial(int state);
+
+    /**
+     * Set the state final, if present
+     */
+    void setFinal(int state);
+
+    /**
+     * Tell if the states are numbered from 0 to size() - 1
+     */
+    bool isCompact() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+  private:
+    enum Flag : unsigned char { Present = 1, Initial = 2, Final = 4 };
+
+    std::pmr::vector<unsigned char> flags; // drapeaux de chaque indice
+    std::size_t count;
+    bool sparse;
+    std::pmr::map<int, std::size_t> indices; // numéro -> indice, en mode creux
+    std::pmr::vector<std::size_t> free_indices; // indices libres, en mode creux
+
+    /**
+    * Permet d'obtenir l'indice d'un état, ou flags.size() s'il est absent
+    */
+    std::size_t find_index(int state) const;
+
+    /**
+    * Permet de passer en mode creux, quand les numéros d'états sont trop grands
+    */
+    void make_sparse();
+  };
+
+  /**
+   * Set of the symbols of an automaton
+   *
+   * Every byte except Epsilon may be a symbol. The set is a bitmap of 256
+   * bits, so that a symbol is added, removed or looked up in constant time.
+   * Iteration visits the symbols in increasing order of char, like a
+   * std::set<char>.
+   */
+  class Alphabet {
+  public:
+    class const_iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = char;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const char*;
+      using reference = char;
+
+      char operator*() const;
+      const_iterator& operator++();
+      bool operator==(const const_iterator& other) const;
+      bool operator!=(const const_iterator& other) const;
+
+    private:
+      friend class Alphabet;
+      const Alphabet* alphabet;
+      std::size_t position; // rang du symbole dans l'ordre des char, 256 à la fin
+    };
+
+    /**
+     * Build an empty alphabet
+     */
+    Alphabet();
+
+    /**
+     * Add a symbol, returns true if it was not present
+     */
+    bool insert(char symbol);
+
+    /**
+     * Add the symbols of a range
+     */
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+      for (; first != last; ++first) {
+        insert(*first);
+      }
+    }
+
+    /**
+     * Remove a symbol, returns true if it was present
+     */
+    bool erase(char symbol);
+
+    /**
+     * Tell if a symbol is present
+     */
+    bool contains(char symbol) const;
+
+    /**
+     * Remove all the symbols
+     */
+    void clear();
+
+    std::size_t size() const;
+    bool empty() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    bool operator==(const Alphabet& other) const;
+    bool operator!=(const Alphabet& other) const;
+
+  private:
+    std::uint64_t bits[4]; // bit du rang de chaque symbole dans l'ordre des char
+    std::size_t count;
+
+    /**
+    * Permet d'obtenir le rang d'un symbole dans l'ordre des char
+    */
+    static std::size_t position_of(char symbol);
+
+    /**
+    * Permet d'obtenir le rang du premier symbole présent à partir d'un rang
+    */
+    std::size_t next_position(std::size_t position) const;
+  };
+
+  class FrozenAutomaton;
+  struct ConstructionResult;
+
   class Automaton {
   public:
-    std::set<char> alphabet;//l'ensemble des symboles de l'automate
-    std::map<int, struct State> set_of_states; //l'ensemble des états de l'automate  
-    std::vector<struct Transition> set_of_transitions; //l'ensemble des transitions de l'automate
+    Alphabet alphabet;//l'ensemble des symboles de l'automate
+    StateTable set_of_states; //l'ensemble des états de l'automate
+    std::pmr::vector<struct Transition> set_of_transitions; //l'ensemble des transitions de l'automate
     
     /**
      * Build an empty automaton (no state, no transition).
+     *
+     * The memory comes from the default memory resource.
      */
     Automaton();
 
+    /**
+     * Build an empty automaton whose memory comes from the given resource
+     *
+     * The automata created by the static methods use the memory resource of
+     * their (first) argument, so that a whole transformation can run in an
+     * arena such as std::pmr::monotonic_buffer_resource. Like for the
+     * standard containers, a copy-constructed automaton uses the default
+     * resource, while an assigned automaton keeps its own resource.
+     */
+    explicit Automaton(std::pmr::memory_resource* resource);
+
+    /**
+     * Get the memory resource of the automaton
+     */
+    std::pmr::memory_resource* getResource() const;
+
+    /**
+     * Set the function called at the end of each instrumented operation
+     *
+     * The static methods building automata report their statistics, which
+     * include those of the operations they call. The statistics are only
+     * collected when the library is compiled with FA_STATS defined (CMake
+     * option FA_ENABLE_STATS); otherwise the callback is never called and
+     * the instrumentation costs nothing. The callback must not be changed
+     * while operations run on other threads.
+     */
+    static void setStatsCallback(StatsCallback callback);
+
+    /**
+     * Get the generation of the automaton
+     *
+     * The generation is incremented by every modifying method and by
+     * invalidate. The structural properties (determinism, completeness, ...)
+     * and the compiled form used by match are computed once and then cached
+     * until the generation changes, so that a repeated query costs O(1).
+     * The cache is published atomically, so that const queries may run
+     * concurrently on the same automaton.
+     */
+    std::size_t getGeneration() const;
+
+    /**
+     * Invalidate the cached properties after a direct change of the members
+     *
+     * The public members may be modified without the methods, for instance
+     * to add transitions in bulk; invalidate must then be called before the
+     * next query, otherwise the cached answers are those of the old content.
+     */
+    void invalidate();
+
     /**
      * Tell if an automaton is valid.
      *
@@ -62,6 +393,14 @@ namespace fa {
      */
     bool isValid() const;
 
+    /**
+     * Tell if a symbol may be added to an automaton
+     *
+     * Every byte except Epsilon is a valid symbol, including whitespace,
+     * control characters and the bytes of UTF-8 sequences.
+     */
+    static bool isValidSymbol(char symbol);
+
     /**
      * Add a symbol to the automaton
      *
@@ -158,6 +497,30 @@ namespace fa {
      */
     std::size_t countTransitions() const;
 
+    /**
+     * Tell if the states are numbered from 0 to countStates() - 1
+     */
+    bool isCompact() const;
+
+    /**
+     * Renumber the states from 0 to countStates() - 1
+     *
+     * The states are numbered in breadth-first order from the initial
+     * states, following transitions by increasing symbol, so that states
+     * used together get close numbers. The states which are not accessible
+     * come last, by increasing number.
+     * Returns the new number of each state.
+     */
+    std::map<int, int> compact();
+
+    /**
+     * Build an immutable copy of the automaton, optimized for queries
+     *
+     * The transitions are stored in a compressed sparse row layout. Later
+     * changes to the automaton are not reflected in the result.
+     */
+    FrozenAutomaton freeze() const;
+
     /**
      * Print the automaton in a friendly way
      */
@@ -165,8 +528,25 @@ namespace fa {
 
     /**
      * Print the automaton with respect to the DOT specification
+     *
+     * The transitions between two states are printed as one edge, labelled
+     * by their symbols. If merge_ranges is true, three or more consecutive
+     * symbols are written as a range, such as a-z. Control and non-ASCII
+     * bytes, ',' and '-' are written \xHH, so that the label stays readable.
      */
-    // void dotPrint(std::ostream& os) const;
+    void dotPrint(std::ostream& os, bool merge_ranges = false) const;
+
+    /**
+     * Print a standalone C++ function accepting the language of the automaton
+     *
+     * The function is declared as
+     *   inline bool function_name(const char* text, std::size_t length)
+     * and simulates the minimal automaton, either with a switch on the
+     * current state in a loop, or with one label per state and gotos. The
+     * dead state is replaced by an early return. Like Automaton::match,
+     * epsilon-transitions are not followed.
+     */
+    void cppPrint(std::ostream& os, const std::string& function_name, CodeStyle style = CodeStyle::Switch) const;
 
     /**
      * Tell if the automaton has one or more epsilon-transition
@@ -183,6 +563,39 @@ namespace fa {
      */
     bool isComplete() const;
 
+    /**
+     * Find the first reason why the automaton is not deterministic
+     *
+     * The states are checked by increasing number. If there is not exactly
+     * one initial state, the result has no state when there is none, or the
+     * second initial state. Otherwise, it gives the state with an
+     * epsilon-transition (and the symbol Epsilon), or with two transitions
+     * on the same symbol.
+     */
+    PropertyViolation findNonDeterminism() const;
+
+    /**
+     * Find the first state and symbol without transition
+     *
+     * The states are checked by increasing number, and the symbols in order.
+     */
+    PropertyViolation findMissingTransition() const;
+
+    /**
+     * Tell if every state is accessible and co-accessible
+     */
+    bool isTrimmed() const;
+
+    /**
+     * Get the initial states, by increasing number
+     */
+    std::vector<int> getInitialStates() const;
+
+    /**
+     * Count the number of final states
+     */
+    std::size_t countFinalStates() const;
+
     /**
      * Remove non-accessible states
      */
@@ -205,14 +618,27 @@ namespace fa {
 
     /**
      * Read the string and compute the state set after traversing the automaton
+     *
+     * The automaton is compiled by the first reading, and the compiled form
+     * is cached like the structural properties, until the next modification.
      */
     std::set<int> readString(const std::string& word) const;
 
     /**
      * Tell if the word is in the language accepted by the automaton
+     *
+     * Like readString, the compiled form of the automaton is cached.
      */
     bool match(const std::string& word) const;
 
+    /**
+     * Find the leftmost-longest factor of the text in the language
+     *
+     * The result gives the offsets [start, end) of the factor. To search
+     * several texts, build a SubstringSearcher once instead.
+     */
+    SearchResult search(std::string_view text) const;
+
     /**
      * Tell if the langage accepted by the automaton is included in the
      * language accepted by the other automaton
@@ -231,9 +657,19 @@ namespace fa {
 
     /**
      * Create a complement automaton
+     *
+     * The intermediate automata are built in a monotonic arena.
      */
     static Automaton createComplement(const Automaton& automaton);
 
+    /**
+     * Create an equivalent automaton without epsilon-transition
+     *
+     * Each state gets the transitions and the finality of the states it
+     * reaches through epsilon-transitions.
+     */
+    static Automaton createWithoutEpsilon(const Automaton& automaton);
+
     /**
      * Create the product of two automata
      *
@@ -241,23 +677,125 @@ namespace fa {
      */
     static Automaton createProduct(const Automaton& lhs, const Automaton& rhs);
 
+    /**
+     * Create the product of two automata, with a budget of states
+     *
+     * Only the pairs of states accessible from the initial pairs are built.
+     * The construction stops when it would exceed options.max_states states
+     * or when options.cancel becomes true.
+     */
+    static ConstructionResult createProduct(const Automaton& lhs, const Automaton& rhs, const ConstructionOptions& options);
+
+    /**
+     * Create the union of two automata
+     *
+     * The union of two automata accept the union of the two languages.
+     */
+    static Automaton createUnion(const Automaton& lhs, const Automaton& rhs);
+
+    /**
+     * Create the concatenation of two automata
+     *
+     * If with_epsilon is true, the final states of lhs are linked to the
+     * initial states of rhs by epsilon-transitions. Otherwise, the final
+     * states of lhs get the transitions leaving the initial states of rhs.
+     */
+    static Automaton createConcatenation(const Automaton& lhs, const Automaton& rhs, bool with_epsilon = false);
+
+    /**
+     * Create the Kleene star of an automaton
+     *
+     * A new state, initial and final, accepts the empty word. If with_epsilon
+     * is true, it is linked to the initial states and the final states are
+     * linked back to it by epsilon-transitions. Otherwise, it and the final
+     * states get the transitions leaving the initial states.
+     */
+    static Automaton createKleeneStar(const Automaton& automaton, bool with_epsilon = false);
+
     /**
      * Create a deterministic automaton, if not already deterministic
      */
     static Automaton createDeterministic(const Automaton& other);
 
+    /**
+     * Create a deterministic automaton, with a budget of states
+     *
+     * The construction stops when it would exceed options.max_states states
+     * or when options.cancel becomes true.
+     */
+    static ConstructionResult createDeterministic(const Automaton& other, const ConstructionOptions& options);
+
     /**
      * Create an equivalent minimal automaton with the Moore algorithm
+     *
+     * The result is compact.
      */
     static Automaton createMinimalMoore(const Automaton& other);
 
+    /**
+     * Create an equivalent minimal automaton with the Moore algorithm,
+     * computing the signatures of each refinement round on several threads
+     *
+     * If nb_threads is 0, the number of hardware threads is used.
+     * The result is compact.
+     */
+    static Automaton createMinimalMooreParallel(const Automaton& other, std::size_t nb_threads = 0);
+
     /**
      * Create an equivalent minimal automaton with the Brzozowski algorithm
+     *
+     * The intermediate automata are built in a monotonic arena.
      */
     static Automaton createMinimalBrzozowski(const Automaton& other);
 
+    /**
+     * Create an equivalent minimal automaton with the Brzozowski algorithm,
+     * with a budget of states
+     *
+     * The budget applies to each of the two determinizations.
+     */
+    static ConstructionResult createMinimalBrzozowski(const Automaton& other, const ConstructionOptions& options);
+
+    /**
+     * Create the Aho-Corasick automaton of a set of keywords
+     *
+     * The automaton is deterministic and complete, and accepts the words
+     * ending with one of the keywords. The failure links are compiled into
+     * the transitions. Keywords containing an invalid symbol are ignored.
+     */
+    static Automaton createAhoCorasick(const std::vector<std::string>& keywords);
+
 
   private:
+    //Structure des propriétés calculées de l'automate, jamais modifiée une fois publiée
+    struct Properties {
+      std::size_t generation;
+      bool deterministic;
+      bool complete;
+      bool has_epsilon;
+      bool language_empty;
+      bool trimmed;
+      std::vector<int> initial_states;
+      std::size_t nb_final_states;
+    };
+
+    std::size_t generation;
+    mutable std::shared_ptr<const Properties> properties; // lu et écrit atomiquement
+
+    /**
+    * Permet d'obtenir les propriétés de l'automate, calculées si besoin
+    */
+    std::shared_ptr<const Properties> get_properties() const;
+
+    //Structure de l'automate compilé par match et readString, définie dans Automaton.cc
+    struct Matcher;
+    mutable std::shared_ptr<const Matcher> matcher; // lu et écrit atomiquement
+
+    /**
+    * Permet d'obtenir l'automate compilé utilisé pour la lecture, construit si besoin
+    */
+    std::shared_ptr<const Matcher> get_matcher() const;
+
     /**
      * Permet de savoir si un état est accessible depuis un état initial
     */
@@ -268,17 +806,392 @@ namespace fa {
     */
     void find_final_state(std::set<int>& statesBrowseGlobal, std::set<int>& statesBrowseLocal, int state, int state_begin) const;
      
-    /**
-    * Permet de parcourir l'automate pour voir s'il a un langage vide
-    */
-    void browse_automaton(std::set<int> statesBrowse, int state , int& nb) const;
-    
     /**
     * Permet d'obtenir les états accessibles depuis un état grâce à un symbole
     */
     std::set<int> state_after_move(char next_symbol, std::set<int> states) const;
   };
 
+  //Structure du résultat d'une construction longue
+  struct ConstructionResult {
+    ConstructionStatus status;
+    Automaton automaton; // vide si la construction n'est pas terminée
+  };
+
+  /**
+   * Immutable automaton with a compressed sparse row layout
+   *
+   * The states are numbered by increasing number from 0. The transitions
+   * leaving a state are contiguous, sorted by symbol then by target, so that
+   * the transitions on a symbol are found by a binary search, and the
+   * structural properties are checked in linear time.
+   * Like Automaton::readString, epsilon-transitions are not followed.
+   */
+  class FrozenAutomaton {
+  public:
+    /**
+     * Build the layout of the automaton
+     */
+    explicit FrozenAutomaton(const Automaton& automaton);
+
+    /**
+     * Count the number of states
+     */
+    std::size_t countStates() const;
+
+    /**
+     * Count the number of transitions
+     */
+    std::size_t countTransitions() const;
+
+    /**
+     * Tell if the automaton is deterministic
+     */
+    bool isDeterministic() const;
+
+    /**
+     * Tell if the automaton is complete
+     */
+    bool isComplete() const;
+
+    /**
+     * Find the first reason why the automaton is not deterministic
+     *
+     * See Automaton::findNonDeterminism.
+     */
+    PropertyViolation findNonDeterminism() const;
+
+    /**
+     * Find the first state and symbol without transition
+     */
+    PropertyViolation findMissingTransition() const;
+
+    /**
+     * Check if the language of the automaton is empty
+     */
+    bool isLanguageEmpty() const;
+
+    /**
+     * Tell if every state is accessible and co-accessible
+     */
+    bool isTrimmed() const;
+
+    /**
+     * Read the string and compute the state set after traversing the automaton
+     */
+    std::set<int> readString(const std::string& word) const;
+
+    /**
+     * Tell if the word is in the language accepted by the automaton
+     */
+    bool match(const std::string& word) const;
+
+  private:
+    std::vector<int> states; // numéro de chaque état, par ordre croissant
+    std::vector<char> alphabet; // symboles triés
+    std::vector<unsigned char> initial_states; // 1 si l'état est initial
+    std::vector<int> initial_indices; // indices des états initiaux, pour la lecture
+    std::vector<unsigned char> final_states; // 1 si l'état est final
+    std::vector<std::size_t> offsets; // début des transitions de chaque état
+    std::vector<char> symbols; // symbole de chaque transition
+    std::vector<int> targets; // indice de l'état d'arrivée de chaque transition
+
+    /**
+    * Permet d'obtenir l'indice d'un état à partir de son numéro, ou -1
+    */
+    int index_of(int state) const;
+
+    /**
+    * Permet d'ajouter à next les successeurs des états de current par un symbole
+    */
+    void move(const std::vector<int>& current, char symbol, std::vector<int>& next) const;
+  };
+
+  /**
+   * Automaton compiled for bit-parallel simulation
+   *
+   * Each set of states is a 64-bit word. For every symbol, the successors
+   * of each group of 4 states are precomputed for the 16 possible subsets,
+   * so reading one symbol costs one table lookup per group of 4 states.
+   * Like Automaton::readString, epsilon-transitions are not followed.
+   */
+  class BitParallelAutomaton {
+  public:
+    /**
+     * Maximum number of states of a compilable automaton
+     */
+    static constexpr std::size_t MaxStates = 64;
+
+    /**
+     * Compile the automaton
+     *
+     * If the automaton has more than MaxStates states, the result is not valid.
+     */
+    explicit BitParallelAutomaton(const Automaton& automaton);
+
+    /**
+     * Tell if the automaton could be compiled
+     */
+    bool isValid() const;
+
+    /**
+     * Read the string and compute the state set after traversing the automaton
+     */
+    std::set<int> readString(const std::string& word) const;
+
+    /**
+     * Tell if the word is in the language accepted by the automaton
+     */
+    bool match(const std::string& word) const;
+
+  private:
+    bool valid;
+    std::size_t nb_groups;
+    std::vector<int> states; // numéro de l'état associé à chaque bit
+    int symbol_index[256]; // -1 si le symbole n'est pas dans l'alphabet
+    std::vector<std::uint64_t> table; // [symbole][groupe][sous-ensemble]
+    std::uint64_t initial_states;
+    std::uint64_t final_states;
+
+    /**
+    * Permet d'obtenir l'ensemble d'états atteint après lecture du mot
+    */
+    std::uint64_t read(const std::string& word) const;
+  };
+
+  /**
+   * Deterministic automaton built on demand while reading words
+   *
+   * The macrostates (sets of states of the original automaton) and their
+   * transitions are only computed when they are visited, and kept in a cache
+   * of bounded size that is flushed when full. If the cache is flushed too
+   * often while reading a single word, the end of the word is read by a
+   * simulation of the original automaton. Like Automaton::readString,
+   * epsilon-transitions are not followed.
+   */
+  class LazyDeterministicAutomaton {
+  public:
+    /**
+     * Prepare the automaton, with at most max_cached_states macrostates in cache
+     *
+     * max_flushes is the number of flushes allowed while reading a word
+     * before falling back to the simulation of the original automaton.
+     */
+    explicit LazyDeterministicAutomaton(const Automaton& automaton, std::size_t max_cached_states = 4096, std::size_t max_flushes = 3);
+
+    /**
+     * Tell if the word is in the language accepted by the automaton
+     */
+    bool match(const std::string& word);
+
+    /**
+     * Count the number of macrostates currently in cache
+     */
+    std::size_t countCachedStates() const;
+
+    /**
+     * Count the number of times the cache has been flushed
+     */
+    std::size_t countFlushes() const;
+
+  private:
+    std::size_t nb_symbols;
+    int symbol_index[256]; // -1 si le symbole n'est pas dans l'alphabet
+    std::vector<std::vector<int>> successors; // [état * nb_symbols + symbole]
+    std::vector<bool> final_states;
+    std::vector<int> initial_macrostate;
+
+    std::size_t max_cached_states;
+    std::size_t max_flushes;
+    std::size_t nb_flushes;
+    std::map<std::vector<int>, int> macrostate_numbers;
+    std::vector<std::vector<int>> macrostates;
+    std::vector<bool> macrostate_final;
+    std::vector<int> cached_transitions; // [macro-état * nb_symbols + symbole], -1 si inconnue
+
+    /**
+    * Permet d'obtenir le numéro d'un macro-état, en l'ajoutant au cache si besoin
+    */
+    int find_macrostate(const std::vector<int>& macrostate);
+
+    /**
+    * Permet d'obtenir les états accessibles depuis un macro-état grâce à un symbole
+    */
+    std::vector<int> move(const std::vector<int>& macrostate, int symbol) const;
+
+    /**
+    * Permet de vider le cache
+    */
+    void flush();
+  };
+
+  /**
+   * Automaton compiled for unanchored search
+   *
+   * The deterministic automaton accepting the words that end with a word of
+   * the language is built once. While no match is in progress, the text is
+   * skipped up to the next byte that can start a match, with SSE2 or AVX2
+   * scanning when the processor supports it. Like Automaton::readString,
+   * epsilon-transitions are not followed.
+   */
+  class SubstringSearcher {
+  public:
+    /**
+     * Compile the automaton
+     */
+    explicit SubstringSearcher(const Automaton& automaton);
+
+    /**
+     * Tell if a factor of the text is in the language accepted by the automaton
+     */
+    bool matchSubstring(std::string_view text) const;
+
+    /**
+     * Find the leftmost-longest factor of the text in the language
+     *
+     * The leftmost start is found by reading the text backwards with the
+     * automaton of the mirror language, then the longest end by reading
+     * forward from this start.
+     */
+    SearchResult search(std::string_view text) const;
+
+    /**
+     * Count the number of bytes that can start a non-empty match
+     */
+    std::size_t countFirstBytes() const;
+
+  private:
+    std::vector<int> transitions; // [état * 256 + octet], état 0 initial
+    std::vector<bool> final_states;
+    std::vector<int> mirror_transitions; // même disposition, langage miroir
+    std::vector<bool> mirror_final_states;
+    std::vector<int> anchored_transitions; // même disposition, -1 si état puits
+    std::vector<bool> anchored_final_states;
+    std::vector<unsigned char> first_bytes;
+    bool is_first_byte[256];
+
+    /**
+    * Permet d'obtenir la position du prochain octet pouvant débuter une
+    * correspondance, ou la fin du texte
+    */
+    std::size_t find_first_byte(std::string_view text, std::size_t begin) const;
+
+    /**
+    * Permet d'obtenir la fin de la première correspondance, ou npos
+    */
+    std::size_t find_first_end(std::string_view text) const;
+  };
+
+  /**
+   * Deterministic automaton merging several patterns
+   *
+   * Each state carries the set of the patterns accepting the words leading
+   * to it, so all the matching patterns are found with a single reading of
+   * the word. Like Automaton::readString, epsilon-transitions are not
+   * followed.
+   */
+  class MultiPatternAutomaton {
+  public:
+    /**
+     * Merge the patterns into a single deterministic automaton
+     */
+    explicit MultiPatternAutomaton(const std::vector<Automaton>& patterns);
+
+    /**
+     * Compute the indices of the patterns accepting the word, in increasing order
+     */
+    std::vector<std::size_t> match(const std::string& word) const;
+
+    /**
+     * Count the number of patterns
+     */
+    std::size_t countPatterns() const;
+
+    /**
+     * Count the number of states of the merged automaton
+     */
+    std::size_t countStates() const;
+
+  private:
+    std::size_t nb_patterns;
+    std::size_t nb_words; // nombre de mots de 64 bits par ensemble de patrons
+    std::vector<int> transitions; // [état * 256 + octet], état 0 initial, -1 si état puits
+    std::vector<std::uint64_t> pattern_bits; // [état * nb_words + mot]
+  };
+
+  /**
+   * Incremental construction of the minimal automaton of a finite language
+   *
+   * The words must be added in increasing lexicographic order. With the
+   * Daciuk-Mihov algorithm, the automaton stays minimal apart from the
+   * path of the last word: the other states are kept in a register of
+   * unique states, so the memory used stays close to the size of the
+   * minimal automaton.
+   */
+  class MinimalAcyclicBuilder {
+  public:
+    /**
+     * Build an empty builder (empty language)
+     */
+    MinimalAcyclicBuilder();
+
+    /**
+     * Add a word
+     *
+     * Returns true if the word was effectively added, and false if it is not
+     * greater than the previously added word or contains an invalid symbol.
+     */
+    bool addWord(const std::string& word);
+
+    /**
+     * Count the number of states currently used
+     */
+    std::size_t countStates() const;
+
+    /**
+     * Create the minimal deterministic automaton accepting the added words
+     *
+     * The automaton is trimmed, thus not complete.
+     */
+    Automaton createAutomaton() const;
+
+  private:
+    //Structure d'un état du constructeur
+    struct Node {
+      bool isFinal;
+      std::vector<std::pair<char, int>> transitions; // triées par symbole
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> free_nodes; // états remplacés, réutilisables
+    std::unordered_multimap<std::size_t, int> register_of_states; // empreinte -> état
+    std::string last_word;
+    std::vector<int> path; // états lus par le dernier mot, path[0] initial
+    bool has_word;
+
+    /**
+    * Permet de remplacer les états du chemin du dernier mot au-delà de la
+    * longueur donnée par un équivalent du registre, ou de les y ajouter
+    */
+    void replace_or_register(std::size_t length);
+
+    /**
+    * Permet de créer un nouvel état, en réutilisant un état libéré si possible
+    */
+    int new_node();
+
+    /**
+    * Permet de calculer l'empreinte d'un état : finalité et transitions
+    */
+    static std::size_t node_hash(const Node& node);
+
+    /**
+    * Permet de trouver un état du registre de même finalité et de mêmes
+    * transitions, renvoie -1 si aucun
+    */
+    int find_registered(const Node& node) const;
+  };
+
 }
 
 #endif // AUTOMATON_H
@@ -0,0 +1,485 @@
+#include "Parser.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <ostream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FA_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fa {
+
+/**
+ * Permet de découper un texte en lignes, sans copie
+ */
+template <typename Function>
+static bool for_each_line(std::string_view text, std::size_t& line_number, Function function) {
+  line_number = 0;
+  const char* current = text.data();
+  const char* end = text.data() + text.size();
+  while (current < end) {
+    const char* newline = static_cast<const char*>(std::memchr(current, '\n', end - current));
+    const char* line_end = (newline == nullptr) ? end : newline;
+    std::string_view line(current, line_end - current);
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    line_number++;
+    if (!function(line)) {
+      return false;
+    }
+    current = (newline == nullptr) ? end : newline + 1;
+  }
+  line_number = 0;
+  return true;
+}
+
+/**
+ * Permet de savoir si un caractère sépare deux mots d'une ligne
+ */
+static bool is_blank(char c) {
+  return c == ' ' || c == '\t';
+}
+
+/**
+ * Permet de retirer les blancs au début et à la fin d'une ligne
+ */
+static std::string_view trim(std::string_view line) {
+  while (!line.empty() && is_blank(line.front())) {
+    line.remove_prefix(1);
+  }
+  while (!line.empty() && is_blank(line.back())) {
+    line.remove_suffix(1);
+  }
+  return line;
+}
+
+/**
+ * Permet d'extraire le prochain mot d'une ligne, vide à la fin de la ligne
+ */
+static std::string_view next_token(std::string_view& line) {
+  std::size_t begin = 0;
+  while (begin < line.size() && is_blank(line[begin])) {
+    begin++;
+  }
+  std::size_t end = begin;
+  while (end < line.size() && !is_blank(line[end])) {
+    end++;
+  }
+  std::string_view token = line.substr(begin, end - begin);
+  line.remove_prefix(end);
+  return token;
+}
+
+/**
+ * Permet de lire un numéro d'état positif, renvoie false si le mot n'en est pas un
+ */
+static bool parse_state(std::string_view token, int& state) {
+  const char* end = token.data() + token.size();
+  auto [position, error] = std::from_chars(token.data(), end, state);
+  return error == std::errc() && position == end && state >= 0;
+}
+
+/**
+ * Permet de lire un symbole, "eps" désignant Epsilon et "\xHH" l'octet HH
+ */
+static bool parse_symbol(std::string_view token, char& symbol) {
+  if (token == "eps") {
+    symbol = fa::Epsilon;
+    return true;
+  }
+  if (token.size() == 4 && token[0] == '\\' && token[1] == 'x') {
+    unsigned int byte;
+    auto [position, error] = std::from_chars(token.data() + 2, token.data() + 4, byte, 16);
+    if (error != std::errc() || position != token.data() + 4 || byte == 0) {
+      return false;
+    }
+    symbol = static_cast<char>(byte);
+    return true;
+  }
+  if (token.size() != 1 || !Automaton::isValidSymbol(token[0])) {
+    return false;
+  }
+  symbol = token[0];
+  return true;
+}
+
+/**
+ * Permet d'écrire un symbole, les séparateurs et les octets invisibles en "\xHH"
+ */
+static void print_symbol(std::ostream& os, char symbol) {
+  unsigned char byte = symbol;
+  if (isgraph(byte) && symbol != ',') {
+    os << symbol;
+    return;
+  }
+  const char* digits = "0123456789abcdef";
+  os << "\\x" << digits[byte / 16] << digits[byte % 16];
+}
+
+//Structure de l'état de la lecture en bloc d'un automate
+struct BulkBuilder {
+  std::array<bool, 256> symbols = {}; // symboles rencontrés
+  std::vector<bool> states;           // états rencontrés, pour les petits numéros
+  std::set<int> other_states;         // états rencontrés, pour les grands numéros
+  std::vector<int> initial_states;
+  std::vector<int> final_states;
+
+  /**
+   * Permet de noter un état, ajouté à l'automate à la fin
+   */
+  void addState(int state) {
+    if (static_cast<std::size_t>(state) < states.size()) {
+      states[state] = true;
+    } else {
+      other_states.insert(state);
+    }
+  }
+
+  /**
+   * Permet de finir la construction de l'automate
+   *
+   * Les états sont ajoutés par numéros croissants, pour que la table des
+   * états reste dense quand les numéros se suivent.
+   */
+  void finish(Automaton& automaton) const {
+    for (std::size_t state = 0; state < states.size(); state++) {
+      if (states[state]) {
+        automaton.set_of_states.insert(state);
+      }
+    }
+    for (int state : other_states) {
+      automaton.set_of_states.insert(state);
+    }
+    for (int state : initial_states) {
+      automaton.setStateInitial(state);
+    }
+    for (int state : final_states) {
+      automaton.setStateFinal(state);
+    }
+    for (std::size_t symbol = 1; symbol < symbols.size(); symbol++) {
+      if (symbols[symbol]) {
+        automaton.addSymbol(static_cast<char>(symbol));
+      }
+    }
+    removeDuplicateTransitions(automaton.set_of_transitions);
+    automaton.invalidate();
+
+    // On renvoie un automate valide
+    if (automaton.countStates() == 0) {
+      automaton.addState(0);
+      automaton.setStateInitial(0);
+    }
+    if (automaton.countSymbols() == 0) {
+      automaton.addSymbol('a');
+    }
+  }
+};
+
+/**
+ * Permet de lire une ligne du format simple, renvoie false si elle est mal formée
+ */
+static bool parse_simple_line(std::string_view line, Automaton& automaton, BulkBuilder& builder) {
+  std::string_view first = next_token(line);
+  if (first.empty() || first.front() == '#') {
+    return true;
+  }
+
+  // Ligne d'états initiaux, finaux, ou de symboles
+  if (first == "initial" || first == "final") {
+    std::vector<int>& states = (first == "initial") ? builder.initial_states : builder.final_states;
+    for (std::string_view token = next_token(line); !token.empty(); token = next_token(line)) {
+      int state;
+      if (!parse_state(token, state)) {
+        return false;
+      }
+      builder.addState(state);
+      states.push_back(state);
+    }
+    return true;
+  }
+  if (first == "alphabet") {
+    for (std::string_view token = next_token(line); !token.empty(); token = next_token(line)) {
+      char symbol;
+      if (!parse_symbol(token, symbol) || symbol == fa::Epsilon) {
+        return false;
+      }
+      builder.symbols[static_cast<unsigned char>(symbol)] = true;
+    }
+    return true;
+  }
+
+  // Ligne de transition
+  int from, to;
+  char symbol;
+  if (!parse_state(first, from) || !parse_symbol(next_token(line), symbol) ||
+      !parse_state(next_token(line), to) || !next_token(line).empty()) {
+    return false;
+  }
+  builder.symbols[static_cast<unsigned char>(symbol)] = true;
+  builder.addState(from);
+  builder.addState(to);
+  automaton.set_of_transitions.push_back({from, symbol, to});
+  return true;
+}
+
+/**
+ * Permet de lire un texte au format BA
+ */
+static ParseResult parse_ba(std::string_view text) {
+  ParseResult result = {true, 0, Automaton()};
+  Automaton& automaton = result.automaton;
+  automaton.set_of_transitions.reserve(std::count(text.begin(), text.end(), '\n') + 1);
+
+  // Numéros des états, les noms pointant dans le texte
+  BulkBuilder builder;
+  builder.states.resize(2 * automaton.set_of_transitions.capacity() + 64);
+  std::unordered_map<std::string_view, int> numbers;
+  auto number_of = [&](std::string_view name) {
+    auto [it, inserted] = numbers.emplace(name, static_cast<int>(numbers.size()));
+    if (inserted) {
+      builder.addState(it->second);
+    }
+    return it->second;
+  };
+
+  // Lit le nom entre crochets au début d'un morceau de ligne
+  auto parse_name = [](std::string_view& line, std::string_view& name) {
+    if (line.empty() || line.front() != '[') {
+      return false;
+    }
+    std::size_t close = line.find(']');
+    if (close == std::string_view::npos || close == 1) {
+      return false;
+    }
+    name = line.substr(1, close - 1);
+    line.remove_prefix(close + 1);
+    return true;
+  };
+
+  bool after_transitions = false;
+  result.valid = for_each_line(text, result.line, [&](std::string_view line) {
+    line = trim(line);
+    if (line.empty()) {
+      return true;
+    }
+
+    // Ligne d'état, initial avant les transitions et final après
+    std::string_view name;
+    if (line.front() == '[') {
+      if (!parse_name(line, name) || !trim(line).empty()) {
+        return false;
+      }
+      int state = number_of(name);
+      (after_transitions ? builder.final_states : builder.initial_states).push_back(state);
+      return true;
+    }
+
+    // Ligne de transition "symbole,[origine]->[destination]"
+    std::size_t comma = line.find(',');
+    if (comma == std::string_view::npos) {
+      return false;
+    }
+    char symbol;
+    std::string_view from_name, to_name;
+    if (!parse_symbol(trim(line.substr(0, comma)), symbol) || symbol == fa::Epsilon) {
+      return false;
+    }
+    line = trim(line.substr(comma + 1));
+    if (!parse_name(line, from_name)) {
+      return false;
+    }
+    line = trim(line);
+    if (line.substr(0, 2) != "->") {
+      return false;
+    }
+    line = trim(line.substr(2));
+    if (!parse_name(line, to_name) || !trim(line).empty()) {
+      return false;
+    }
+
+    int from = number_of(from_name);
+    int to = number_of(to_name);
+    if (!after_transitions && builder.initial_states.empty()) {
+      builder.initial_states.push_back(from);
+    }
+    after_transitions = true;
+    builder.symbols[static_cast<unsigned char>(symbol)] = true;
+    automaton.set_of_transitions.push_back({from, symbol, to});
+    return true;
+  });
+  if (!result.valid) {
+    result.automaton = Automaton();
+    return result;
+  }
+
+  // Sans ligne d'état final, tous les états sont finaux
+  if (builder.final_states.empty()) {
+    for (int state = 0; state < static_cast<int>(numbers.size()); state++) {
+      builder.final_states.push_back(state);
+    }
+  }
+  builder.finish(automaton);
+  return result;
+}
+
+/**
+ * Read an automaton from a text
+ *
+ * Simple format: one item per line, empty lines and lines beginning
+ * with '#' being ignored. "initial" and "final" followed by state
+ * numbers give the initial and final states; "<from> <symbol> <to>"
+ * gives a transition, where the symbol is a single character, "\xHH"
+ * for the byte of hexadecimal value HH, or "eps" for an
+ * epsilon-transition; "alphabet" followed by symbols adds symbols
+ * which are not used by the transitions.
+ *
+ * BA format: the state lines "[name]" before the first transition are
+ * initial, the transitions are "symbol,[from]->[to]", and the state lines
+ * after the transitions are final. Without initial line, the source of
+ * the first transition is initial; without final line, every state is
+ * final. The states are numbered from 0 in order of appearance.
+ *
+ * The lines are read in place, without allocation per line, and the
+ * transitions are added in bulk. Duplicated transitions are merged.
+ */
+ParseResult Parser::parse(std::string_view text, TextFormat format) {
+  if (format == TextFormat::BA) {
+    return parse_ba(text);
+  }
+
+  ParseResult result = {true, 0, Automaton()};
+  Automaton& automaton = result.automaton;
+  std::size_t nb_lines = std::count(text.begin(), text.end(), '\n') + 1;
+  automaton.set_of_transitions.reserve(nb_lines);
+
+  // Au plus deux nouveaux états par ligne, les numéros plus grands sont rares
+  BulkBuilder builder;
+  builder.states.resize(2 * nb_lines + 64);
+  result.valid = for_each_line(text, result.line, [&](std::string_view line) {
+    return parse_simple_line(line, automaton, builder);
+  });
+  if (!result.valid) {
+    result.automaton = Automaton();
+    return result;
+  }
+
+  builder.finish(automaton);
+  return result;
+}
+
+/**
+ * Read an automaton from a file, mapped in memory when possible
+ */
+ParseResult Parser::parseFile(const std::string& path, TextFormat format) {
+#ifdef FA_MMAP
+  int descriptor = open(path.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    return {false, 0, Automaton()};
+  }
+  struct stat status;
+  if (fstat(descriptor, &status) != 0) {
+    close(descriptor);
+    return {false, 0, Automaton()};
+  }
+  std::size_t size = status.st_size;
+  if (size == 0) {
+    close(descriptor);
+    return parse(std::string_view(), format);
+  }
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  close(descriptor);
+  if (data != MAP_FAILED) {
+    // Le fichier est lu une seule fois, du début à la fin
+    madvise(data, size, MADV_SEQUENTIAL);
+    ParseResult result = parse(std::string_view(static_cast<const char*>(data), size), format);
+    munmap(data, size);
+    return result;
+  }
+#endif
+
+  // Lecture du fichier en un seul bloc
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return {false, 0, Automaton()};
+  }
+  std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return parse(content, format);
+}
+
+/**
+ * Write an automaton in a text format
+ *
+ * The BA format has neither epsilon-transitions, which are skipped, nor
+ * a way to tell that there is no final state: such an automaton is read
+ * back with every state final.
+ */
+void Parser::print(std::ostream& os, const Automaton& automaton, TextFormat format) {
+  if (format == TextFormat::BA) {
+    for (const auto& entry : automaton.set_of_states) {
+      if (automaton.isStateInitial(entry.first)) {
+        os << "[" << entry.first << "]\n";
+      }
+    }
+    for (const auto& t : automaton.set_of_transitions) {
+      if (t.symbol == fa::Epsilon) {
+        continue;
+      }
+      print_symbol(os, t.symbol);
+      os << ",[" << t.from << "]->[" << t.to << "]\n";
+    }
+    for (const auto& entry : automaton.set_of_states) {
+      if (automaton.isStateFinal(entry.first)) {
+        os << "[" << entry.first << "]\n";
+      }
+    }
+    return;
+  }
+
+  os << "alphabet";
+  for (char symbol : automaton.alphabet) {
+    os << " ";
+    print_symbol(os, symbol);
+  }
+  os << "\ninitial";
+  for (const auto& entry : automaton.set_of_states) {
+    if (automaton.isStateInitial(entry.first)) {
+      os << " " << entry.first;
+    }
+  }
+  os << "\nfinal";
+  for (const auto& entry : automaton.set_of_states) {
+    if (automaton.isStateFinal(entry.first)) {
+      os << " " << entry.first;
+    }
+  }
+  os << "\n";
+  for (const auto& t : automaton.set_of_transitions) {
+    os << t.from << " ";
+    if (t.symbol == fa::Epsilon) {
+      os << "eps";
+    } else {
+      print_symbol(os, t.symbol);
+    }
+    os << " " << t.to << "\n";
+  }
+}
+
+}
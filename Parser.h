@@ -0,0 +1,68 @@
+
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+#include "Automaton.h"
+
+namespace fa {
+
+  //Format textuel d'un automate
+  enum class TextFormat {
+    Simple, // "initial 0", "final 2", puis une transition "0 a 1" par ligne
+    BA      // format BA : "[p]" initiaux, "a,[p]->[q]" transitions, "[q]" finaux
+  };
+
+  //Structure du résultat de la lecture d'un automate
+  struct ParseResult {
+    bool valid;        // false si le texte est mal formé
+    std::size_t line;  // numéro de la première ligne mal formée, 0 si aucune
+    Automaton automaton;
+  };
+
+  class Parser {
+  public:
+    /**
+     * Read an automaton from a text
+     *
+     * Simple format: one item per line, empty lines and lines beginning
+     * with '#' being ignored. "initial" and "final" followed by state
+     * numbers give the initial and final states; "<from> <symbol> <to>"
+     * gives a transition, where the symbol is a single character, "\xHH"
+     * for the byte of hexadecimal value HH, or "eps" for an
+     * epsilon-transition; "alphabet" followed by symbols adds symbols
+     * which are not used by the transitions.
+     *
+     * BA format: the state lines "[name]" before the first transition are
+     * initial, the transitions are "symbol,[from]->[to]", and the state lines
+     * after the transitions are final. Without initial line, the source of
+     * the first transition is initial; without final line, every state is
+     * final. The states are numbered from 0 in order of appearance.
+     *
+     * The lines are read in place, without allocation per line, and the
+     * transitions are added in bulk. Duplicated transitions are merged.
+     */
+    static ParseResult parse(std::string_view text, TextFormat format);
+
+    /**
+     * Read an automaton from a file, mapped in memory when possible
+     */
+    static ParseResult parseFile(const std::string& path, TextFormat format);
+
+    /**
+     * Write an automaton in a text format
+     *
+     * The BA format has neither epsilon-transitions, which are skipped, nor
+     * a way to tell that there is no final state: such an automaton is read
+     * back with every state final.
+     */
+    static void print(std::ostream& os, const Automaton& automaton, TextFormat format);
+  };
+
+}
+
+#endif // PARSER_H
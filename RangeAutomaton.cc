@@ -0,0 +1,606 @@
+#include "RangeAutomaton.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace fa {
+
+/**
+ * Permet de comparer deux transitions par origine, puis par intervalle
+ */
+static bool transition_less(const RangeTransition& a, const RangeTransition& b) {
+  return std::make_tuple(a.from, a.low, a.high, a.to) <
+         std::make_tuple(b.from, b.low, b.high, b.to);
+}
+
+/**
+ * Permet de savoir si deux transitions sont identiques
+ */
+static bool transition_equal(const RangeTransition& a, const RangeTransition& b) {
+  return a.from == b.from && a.low == b.low && a.high == b.high && a.to == b.to;
+}
+
+/**
+ * Permet de découper les intervalles de transitions en intervalles
+ * élémentaires, et d'appeler function(low, high, targets) pour chacun de ceux
+ * qui sont couverts, avec les destinations triées
+ */
+template <typename Iterator, typename Function>
+static void sweep_intervals(Iterator begin, Iterator end, Function function) {
+  // Un intervalle entre en low et sort en high + 1
+  std::vector<std::tuple<int, int, int>> events; // position, variation, destination
+  for (Iterator it = begin; it != end; ++it) {
+    events.emplace_back(it->low, 1, it->to);
+    events.emplace_back(it->high + 1, -1, it->to);
+  }
+  std::sort(events.begin(), events.end());
+
+  std::map<int, int> active; // destination -> nombre d'intervalles ouverts
+  std::vector<int> targets;
+  std::size_t i = 0;
+  while (i < events.size()) {
+    int position = std::get<0>(events[i]);
+    for (; i < events.size() && std::get<0>(events[i]) == position; i++) {
+      int to = std::get<2>(events[i]);
+      if ((active[to] += std::get<1>(events[i])) == 0) {
+        active.erase(to);
+      }
+    }
+    if (!active.empty()) {
+      targets.clear();
+      for (auto& entry : active) {
+        targets.push_back(entry.first);
+      }
+      function(position, std::get<0>(events[i]) - 1, targets);
+    }
+  }
+}
+
+/**
+ * Build an empty automaton (no state, no transition)
+ */
+RangeAutomaton::RangeAutomaton() {}
+
+/**
+ * Build the automaton of the transitions of an Automaton
+ *
+ * The transitions between the same states by consecutive symbols are
+ * merged into a single interval. Epsilon-transitions are ignored: use
+ * Automaton::createWithoutEpsilon first.
+ */
+RangeAutomaton RangeAutomaton::fromAutomaton(const Automaton& automaton) {
+  RangeAutomaton result;
+  for (const auto& entry : automaton.set_of_states) {
+    result.states.insert(entry.first);
+    if (entry.second.isInitial) {
+      result.states.setInitial(entry.first);
+    }
+    if (entry.second.isFinal) {
+      result.states.setFinal(entry.first);
+    }
+  }
+
+  // Regroupe les symboles de chaque couple d'états par octets croissants
+  std::vector<std::tuple<int, int, RangeSymbol>> symbols;
+  symbols.reserve(automaton.set_of_transitions.size());
+  for (const auto& t : automaton.set_of_transitions) {
+    if (t.symbol != fa::Epsilon) {
+      symbols.emplace_back(t.from, t.to, static_cast<RangeSymbol>(t.symbol));
+    }
+  }
+  std::sort(symbols.begin(), symbols.end());
+  symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+
+  for (std::size_t i = 0; i < symbols.size(); i++) {
+    auto [from, to, byte] = symbols[i];
+    if (!result.transitions.empty() && result.transitions.back().from == from &&
+        result.transitions.back().to == to &&
+        result.transitions.back().high + 1 == byte) {
+      result.transitions.back().high = byte;
+    } else {
+      result.transitions.push_back({from, byte, byte, to});
+    }
+  }
+  std::sort(result.transitions.begin(), result.transitions.end(), transition_less);
+  return result;
+}
+
+/**
+ * Build the equivalent Automaton, with one transition per symbol
+ *
+ * The symbols of the alphabet are those used by the transitions.
+ */
+Automaton RangeAutomaton::toAutomaton() const {
+  Automaton automaton;
+  for (const auto& entry : states) {
+    automaton.addState(entry.first);
+    if (entry.second.isInitial) {
+      automaton.setStateInitial(entry.first);
+    }
+    if (entry.second.isFinal) {
+      automaton.setStateFinal(entry.first);
+    }
+  }
+
+  // Les intervalles d'une même origine peuvent se chevaucher
+  for (const auto& t : transitions) {
+    for (int byte = t.low; byte <= t.high; byte++) {
+      automaton.alphabet.insert(static_cast<char>(byte));
+      automaton.set_of_transitions.push_back({t.from, static_cast<char>(byte), t.to});
+    }
+  }
+  removeDuplicateTransitions(automaton.set_of_transitions);
+  automaton.invalidate();
+
+  // On renvoie un automate valide
+  if (automaton.countStates() == 0) {
+    automaton.addState(0);
+    automaton.setStateInitial(0);
+  }
+  if (automaton.countSymbols() == 0) {
+    automaton.addSymbol('a');
+  }
+  return automaton;
+}
+
+/**
+ * Add a state, returns true if it was not present
+ */
+bool RangeAutomaton::addState(int state) {
+  if (state < 0) {
+    return false;
+  }
+  return states.insert(state);
+}
+
+/**
+ * Tell if a state is present
+ */
+bool RangeAutomaton::hasState(int state) const {
+  return states.contains(state);
+}
+
+/**
+ * Count the number of states
+ */
+std::size_t RangeAutomaton::countStates() const {
+  return states.size();
+}
+
+/**
+ * Set a state initial
+ */
+void RangeAutomaton::setStateInitial(int state) {
+  states.setInitial(state);
+}
+
+/**
+ * Tell if a state is initial
+ */
+bool RangeAutomaton::isStateInitial(int state) const {
+  return states.isInitial(state);
+}
+
+/**
+ * Set a state final
+ */
+void RangeAutomaton::setStateFinal(int state) {
+  states.setFinal(state);
+}
+
+/**
+ * Tell if a state is final
+ */
+bool RangeAutomaton::isStateFinal(int state) const {
+  return states.isFinal(state);
+}
+
+/**
+ * Add a transition by every byte from low to high
+ *
+ * Returns false if a state is missing, if low is Epsilon, if high is
+ * lower than low, or if the transition is already present.
+ */
+bool RangeAutomaton::addTransition(int from, char low, char high, int to) {
+  RangeTransition t = {from, static_cast<RangeSymbol>(low),
+                       static_cast<RangeSymbol>(high), to};
+  if (!hasState(from) || !hasState(to) || low == fa::Epsilon || t.high < t.low) {
+    return false;
+  }
+  auto position = std::lower_bound(transitions.begin(), transitions.end(), t, transition_less);
+  if (position != transitions.end() && transition_equal(*position, t)) {
+    return false;
+  }
+  transitions.insert(position, t);
+  return true;
+}
+
+/**
+ * Tell if a transition is present
+ */
+bool RangeAutomaton::hasTransition(int from, char low, char high, int to) const {
+  RangeTransition t = {from, static_cast<RangeSymbol>(low),
+                       static_cast<RangeSymbol>(high), to};
+  return std::binary_search(transitions.begin(), transitions.end(), t, transition_less);
+}
+
+/**
+ * Count the number of transitions (intervals, not symbols)
+ */
+std::size_t RangeAutomaton::countTransitions() const {
+  return transitions.size();
+}
+
+/**
+ * Get the transitions, sorted by origin, then by interval
+ */
+const std::vector<RangeTransition>& RangeAutomaton::getTransitions() const {
+  return transitions;
+}
+
+/**
+ * Permet d'obtenir les transitions sortant d'un état, triées par intervalle
+ */
+std::pair<std::vector<RangeTransition>::const_iterator,
+          std::vector<RangeTransition>::const_iterator>
+RangeAutomaton::outgoing(int state) const {
+  auto begin = std::lower_bound(
+      transitions.begin(), transitions.end(), state,
+      [](const RangeTransition& t, int from) { return t.from < from; });
+  auto end = std::upper_bound(
+      begin, transitions.end(), state,
+      [](int from, const RangeTransition& t) { return from < t.from; });
+  return {begin, end};
+}
+
+/**
+ * Tell if the automaton is deterministic
+ *
+ * It has at most one initial state, and the intervals leaving a state
+ * towards different states do not overlap.
+ */
+bool RangeAutomaton::isDeterministic() const {
+  std::size_t nb_initial_states = 0;
+  for (const auto& entry : states) {
+    if (entry.second.isInitial) {
+      nb_initial_states++;
+    }
+  }
+  if (nb_initial_states > 1) {
+    return false;
+  }
+
+  for (auto begin = transitions.begin(); begin != transitions.end();) {
+    auto end = outgoing(begin->from).second;
+    bool deterministic = true;
+    sweep_intervals(begin, end, [&](int, int, const std::vector<int>& targets) {
+      if (targets.size() > 1) {
+        deterministic = false;
+      }
+    });
+    if (!deterministic) {
+      return false;
+    }
+    begin = end;
+  }
+  return true;
+}
+
+/**
+ * Tell if the automaton is complete
+ *
+ * The intervals leaving every state cover all the bytes except Epsilon.
+ */
+bool RangeAutomaton::isComplete() const {
+  for (const auto& entry : states) {
+    // Premier octet qui n'est pas encore couvert
+    int next = MinRangeSymbol;
+    auto [begin, end] = outgoing(entry.first);
+    for (auto it = begin; it != end && next <= MaxRangeSymbol; ++it) {
+      if (it->low > next) {
+        return false;
+      }
+      next = std::max(next, it->high + 1);
+    }
+    if (next <= MaxRangeSymbol) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Tell if the word is in the language accepted by the automaton
+ */
+bool RangeAutomaton::match(std::string_view word) const {
+  std::vector<int> current;
+  for (const auto& entry : states) {
+    if (entry.second.isInitial) {
+      current.push_back(entry.first);
+    }
+  }
+
+  std::vector<int> next;
+  for (char c : word) {
+    RangeSymbol byte = c;
+    next.clear();
+    for (int state : current) {
+      auto [begin, end] = outgoing(state);
+      for (auto it = begin; it != end && it->low <= byte; ++it) {
+        if (byte <= it->high) {
+          next.push_back(it->to);
+        }
+      }
+    }
+    std::sort(next.begin(), next.end());
+    next.erase(std::unique(next.begin(), next.end()), next.end());
+    if (next.empty()) {
+      return false;
+    }
+    std::swap(current, next);
+  }
+
+  for (int state : current) {
+    if (isStateFinal(state)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Create an equivalent deterministic automaton
+ *
+ * The macrostates are explored in breadth-first order from the initial
+ * macrostate, numbered 0. The transitions of a macrostate are computed
+ * by sweeping the bounds of the intervals of its states, and adjacent
+ * intervals leading to the same macrostate are merged.
+ */
+RangeAutomaton RangeAutomaton::createDeterministic(const RangeAutomaton& other) {
+  RangeAutomaton result;
+
+  std::map<std::vector<int>, int> numbers;
+  std::vector<std::vector<int>> macrostates;
+  auto number_of = [&](const std::vector<int>& macrostate) {
+    auto [it, inserted] = numbers.emplace(macrostate, static_cast<int>(macrostates.size()));
+    if (inserted) {
+      macrostates.push_back(macrostate);
+      result.states.insert(it->second);
+      for (int state : macrostate) {
+        if (other.isStateFinal(state)) {
+          result.states.setFinal(it->second);
+          break;
+        }
+      }
+    }
+    return it->second;
+  };
+
+  std::vector<int> initial_macrostate;
+  for (const auto& entry : other.states) {
+    if (entry.second.isInitial) {
+      initial_macrostate.push_back(entry.first);
+    }
+  }
+  result.states.setInitial(number_of(initial_macrostate));
+
+  // Parcours en largeur, les transitions sont ajoutées déjà triées
+  std::vector<RangeTransition> pieces;
+  for (std::size_t current = 0; current < macrostates.size(); current++) {
+    pieces.clear();
+    for (int state : macrostates[current]) {
+      auto [begin, end] = other.outgoing(state);
+      pieces.insert(pieces.end(), begin, end);
+    }
+
+    int from = current;
+    sweep_intervals(pieces.begin(), pieces.end(),
+                    [&](int low, int high, const std::vector<int>& targets) {
+      int to = number_of(targets);
+      if (!result.transitions.empty() && result.transitions.back().from == from &&
+          result.transitions.back().to == to &&
+          result.transitions.back().high + 1 == low) {
+        result.transitions.back().high = high;
+      } else {
+        result.transitions.push_back({from, static_cast<RangeSymbol>(low),
+                                      static_cast<RangeSymbol>(high), to});
+      }
+    });
+  }
+  return result;
+}
+
+/**
+ * Create a complete automaton, if not already complete
+ *
+ * The gaps between the intervals of each state lead to a new sink state.
+ */
+RangeAutomaton RangeAutomaton::createComplete(const RangeAutomaton& other) {
+  if (other.isComplete() && other.countStates() > 0) {
+    return other;
+  }
+
+  RangeAutomaton result = other;
+  if (result.countStates() == 0) {
+    result.addState(0);
+    result.setStateInitial(0);
+  }
+
+  // Les états sont parcourus par numéros croissants
+  int sink = 0;
+  for (const auto& entry : result.states) {
+    sink = entry.first + 1;
+  }
+
+  std::vector<RangeTransition> gaps;
+  for (const auto& entry : result.states) {
+    int next = MinRangeSymbol;
+    auto [begin, end] = result.outgoing(entry.first);
+    for (auto it = begin; it != end; ++it) {
+      if (it->low > next) {
+        gaps.push_back({entry.first, static_cast<RangeSymbol>(next),
+                        static_cast<RangeSymbol>(it->low - 1), sink});
+      }
+      next = std::max(next, it->high + 1);
+    }
+    if (next <= MaxRangeSymbol) {
+      gaps.push_back({entry.first, static_cast<RangeSymbol>(next), MaxRangeSymbol, sink});
+    }
+  }
+
+  result.addState(sink);
+  gaps.push_back({sink, MinRangeSymbol, MaxRangeSymbol, sink});
+  result.transitions.insert(result.transitions.end(), gaps.begin(), gaps.end());
+  std::sort(result.transitions.begin(), result.transitions.end(), transition_less);
+  return result;
+}
+
+/**
+ * Create the product of two automata
+ *
+ * Only the pairs of states accessible from the initial pairs are built,
+ * and a pair of transitions gives the intersection of their intervals.
+ */
+RangeAutomaton RangeAutomaton::createProduct(const RangeAutomaton& lhs, const RangeAutomaton& rhs) {
+  RangeAutomaton result;
+
+  std::map<std::pair<int, int>, int> numbers;
+  std::vector<std::pair<int, int>> pairs;
+  auto number_of = [&](int left, int right) {
+    auto [it, inserted] = numbers.emplace(std::make_pair(left, right), static_cast<int>(pairs.size()));
+    if (inserted) {
+      pairs.emplace_back(left, right);
+      result.states.insert(it->second);
+      if (lhs.isStateFinal(left) && rhs.isStateFinal(right)) {
+        result.states.setFinal(it->second);
+      }
+    }
+    return it->second;
+  };
+
+  // Seuls les états initiaux de chaque côté sont appariés
+  std::vector<int> left_initial_states;
+  for (const auto& left : lhs.states) {
+    if (left.second.isInitial) {
+      left_initial_states.push_back(left.first);
+    }
+  }
+  std::vector<int> right_initial_states;
+  for (const auto& right : rhs.states) {
+    if (right.second.isInitial) {
+      right_initial_states.push_back(right.first);
+    }
+  }
+  for (int left : left_initial_states) {
+    for (int right : right_initial_states) {
+      result.states.setInitial(number_of(left, right));
+    }
+  }
+
+  for (std::size_t current = 0; current < pairs.size(); current++) {
+    auto [left_begin, left_end] = lhs.outgoing(pairs[current].first);
+    auto [right_begin, right_end] = rhs.outgoing(pairs[current].second);
+    for (auto left = left_begin; left != left_end; ++left) {
+      // Les intervalles de droite sont triés par borne inférieure
+      for (auto right = right_begin; right != right_end && right->low <= left->high; ++right) {
+        RangeSymbol low = std::max(left->low, right->low);
+        RangeSymbol high = std::min(left->high, right->high);
+        if (low <= high) {
+          int to = number_of(left->to, right->to);
+          result.transitions.push_back({static_cast<int>(current), low, high, to});
+        }
+      }
+    }
+  }
+  std::sort(result.transitions.begin(), result.transitions.end(), transition_less);
+  return result;
+}
+
+/**
+ * Create an equivalent minimal automaton with the Moore algorithm
+ *
+ * The automaton is first made deterministic and complete. The signature
+ * of a state is its class and the sequence of its intervals, merged when
+ * adjacent intervals lead to the same class. The result is compact.
+ */
+RangeAutomaton RangeAutomaton::createMinimal(const RangeAutomaton& other) {
+  // Les états de l'automate complet sont numérotés de 0 à nb_states - 1
+  RangeAutomaton complete = createComplete(createDeterministic(other));
+  std::size_t nb_states = complete.countStates();
+  std::vector<std::size_t> offsets(nb_states + 1, 0);
+  for (const auto& t : complete.transitions) {
+    offsets[t.from + 1]++;
+  }
+  for (std::size_t state = 0; state < nb_states; state++) {
+    offsets[state + 1] += offsets[state];
+  }
+
+  // Signature : classe, puis borne supérieure et classe de chaque intervalle fusionné
+  std::vector<int> classes(nb_states);
+  auto signature_of = [&](std::size_t state, std::vector<int>& signature) {
+    signature.clear();
+    signature.push_back(classes[state]);
+    for (std::size_t i = offsets[state]; i < offsets[state + 1]; i++) {
+      const RangeTransition& t = complete.transitions[i];
+      if (signature.size() > 1 && signature.back() == classes[t.to]) {
+        signature[signature.size() - 2] = t.high;
+      } else {
+        signature.push_back(t.high);
+        signature.push_back(classes[t.to]);
+      }
+    }
+  };
+
+  for (std::size_t state = 0; state < nb_states; state++) {
+    classes[state] = complete.isStateFinal(state) ? 1 : 0;
+  }
+  std::size_t nb_classes = 0;
+  std::vector<int> signature;
+  while (true) {
+    std::map<std::vector<int>, int> numbers;
+    std::vector<int> next_classes(nb_states);
+    for (std::size_t state = 0; state < nb_states; state++) {
+      signature_of(state, signature);
+      next_classes[state] = numbers.emplace(signature, static_cast<int>(numbers.size())).first->second;
+    }
+    classes = std::move(next_classes);
+    if (numbers.size() == nb_classes) {
+      break;
+    }
+    nb_classes = numbers.size();
+  }
+
+  // Un représentant par classe, numérotées dans l'ordre de leur premier état
+  RangeAutomaton result;
+  std::vector<bool> built(nb_classes, false);
+  for (std::size_t state = 0; state < nb_states; state++) {
+    int number = classes[state];
+    if (built[number]) {
+      continue;
+    }
+    built[number] = true;
+    result.states.insert(number);
+    if (complete.isStateInitial(state)) {
+      result.states.setInitial(number);
+    }
+    if (complete.isStateFinal(state)) {
+      result.states.setFinal(number);
+    }
+    signature_of(state, signature);
+    int low = MinRangeSymbol;
+    for (std::size_t i = 1; i < signature.size(); i += 2) {
+      result.transitions.push_back({number, static_cast<RangeSymbol>(low),
+                                    static_cast<RangeSymbol>(signature[i]), signature[i + 1]});
+      low = signature[i] + 1;
+    }
+  }
+  std::sort(result.transitions.begin(), result.transitions.end(), transition_less);
+  return result;
+}
+
+}
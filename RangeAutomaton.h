@@ -0,0 +1,189 @@
+
+#ifndef RANGE_AUTOMATON_H
+#define RANGE_AUTOMATON_H
+
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Automaton.h"
+
+namespace fa {
+
+  //Type des bornes d'un intervalle : un octet, comparé comme unsigned char
+  using RangeSymbol = unsigned char;
+
+  constexpr RangeSymbol MinRangeSymbol = static_cast<RangeSymbol>(Epsilon) + 1; // Epsilon exclu
+  constexpr RangeSymbol MaxRangeSymbol = std::numeric_limits<RangeSymbol>::max();
+
+  //Structure d'une transition étiquetée par un intervalle d'octets
+  struct RangeTransition {
+    int from;
+    RangeSymbol low;  // premier octet de l'intervalle
+    RangeSymbol high; // dernier octet de l'intervalle, inclus
+    int to;
+  };
+
+  /**
+   * Automaton whose transitions are labelled by intervals of symbols
+   *
+   * A transition [low, high] is taken by every byte from low to high, in
+   * byte order (as unsigned char). The alphabet is the set of all the bytes
+   * except Epsilon, and there is no epsilon-transition. A character class
+   * such as [\x01-\xff] is a single transition, so the constructions below
+   * work on the partitions of the alphabet into intervals, and their cost
+   * depends on the number of distinct intervals rather than on the size of
+   * the alphabet. The transitions are kept sorted by origin, then by interval.
+   */
+  class RangeAutomaton {
+  public:
+    /**
+     * Build an empty automaton (no state, no transition)
+     */
+    RangeAutomaton();
+
+    /**
+     * Build the automaton of the transitions of an Automaton
+     *
+     * The transitions between the same states by consecutive symbols are
+     * merged into a single interval. Epsilon-transitions are ignored: use
+     * Automaton::createWithoutEpsilon first.
+     */
+    static RangeAutomaton fromAutomaton(const Automaton& automaton);
+
+    /**
+     * Build the equivalent Automaton, with one transition per symbol
+     *
+     * The symbols of the alphabet are those used by the transitions.
+     */
+    Automaton toAutomaton() const;
+
+    /**
+     * Add a state, returns true if it was not present
+     */
+    bool addState(int state);
+
+    /**
+     * Tell if a state is present
+     */
+    bool hasState(int state) const;
+
+    /**
+     * Count the number of states
+     */
+    std::size_t countStates() const;
+
+    /**
+     * Set a state initial
+     */
+    void setStateInitial(int state);
+
+    /**
+     * Tell if a state is initial
+     */
+    bool isStateInitial(int state) const;
+
+    /**
+     * Set a state final
+     */
+    void setStateFinal(int state);
+
+    /**
+     * Tell if a state is final
+     */
+    bool isStateFinal(int state) const;
+
+    /**
+     * Add a transition by every byte from low to high
+     *
+     * Returns false if a state is missing, if low is Epsilon, if high is
+     * lower than low, or if the transition is already present.
+     */
+    bool addTransition(int from, char low, char high, int to);
+
+    /**
+     * Tell if a transition is present
+     */
+    bool hasTransition(int from, char low, char high, int to) const;
+
+    /**
+     * Count the number of transitions (intervals, not symbols)
+     */
+    std::size_t countTransitions() const;
+
+    /**
+     * Get the transitions, sorted by origin, then by interval
+     */
+    const std::vector<RangeTransition>& getTransitions() const;
+
+    /**
+     * Tell if the automaton is deterministic
+     *
+     * It has at most one initial state, and the intervals leaving a state
+     * towards different states do not overlap.
+     */
+    bool isDeterministic() const;
+
+    /**
+     * Tell if the automaton is complete
+     *
+     * The intervals leaving every state cover all the bytes except Epsilon.
+     */
+    bool isComplete() const;
+
+    /**
+     * Tell if the word is in the language accepted by the automaton
+     */
+    bool match(std::string_view word) const;
+
+    /**
+     * Create an equivalent deterministic automaton
+     *
+     * The macrostates are explored in breadth-first order from the initial
+     * macrostate, numbered 0. The transitions of a macrostate are computed
+     * by sweeping the bounds of the intervals of its states, and adjacent
+     * intervals leading to the same macrostate are merged.
+     */
+    static RangeAutomaton createDeterministic(const RangeAutomaton& other);
+
+    /**
+     * Create a complete automaton, if not already complete
+     *
+     * The gaps between the intervals of each state lead to a new sink state.
+     */
+    static RangeAutomaton createComplete(const RangeAutomaton& other);
+
+    /**
+     * Create the product of two automata
+     *
+     * Only the pairs of states accessible from the initial pairs are built,
+     * and a pair of transitions gives the intersection of their intervals.
+     */
+    static RangeAutomaton createProduct(const RangeAutomaton& lhs, const RangeAutomaton& rhs);
+
+    /**
+     * Create an equivalent minimal automaton with the Moore algorithm
+     *
+     * The automaton is first made deterministic and complete. The signature
+     * of a state is its class and the sequence of its intervals, merged when
+     * adjacent intervals lead to the same class. The result is compact.
+     */
+    static RangeAutomaton createMinimal(const RangeAutomaton& other);
+
+  private:
+    StateTable states;
+    std::vector<RangeTransition> transitions; // triées par origine puis par intervalle
+
+    /**
+    * Permet d'obtenir les transitions sortant d'un état, triées par intervalle
+    */
+    std::pair<std::vector<RangeTransition>::const_iterator,
+              std::vector<RangeTransition>::const_iterator>
+    outgoing(int state) const;
+  };
+
+}
+
+#endif // RANGE_AUTOMATON_H
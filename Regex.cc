@@ -0,0 +1,787 @@
+#include "Regex.h"
+
+#include <cctype>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace fa {
+
+/**
+ * Permet de créer un noeud de l'arbre syntaxique
+ */
+static std::shared_ptr<const RegexNode> make_node(
+    RegexNode::Kind kind, std::shared_ptr<const RegexNode> left = nullptr,
+    std::shared_ptr<const RegexNode> right = nullptr) {
+  return std::make_shared<const RegexNode>(
+      RegexNode{kind, {}, std::move(left), std::move(right)});
+}
+
+/**
+ * Permet de lire le symbole qui suit un '\', "\xHH" désignant l'octet HH
+ */
+static bool read_escaped(const std::string& expression, std::size_t& position, char& c) {
+  if (position >= expression.size()) {
+    return false;
+  }
+  c = expression[position];
+  position++;
+  if (c != 'x' || position + 2 > expression.size() ||
+      !isxdigit(static_cast<unsigned char>(expression[position])) ||
+      !isxdigit(static_cast<unsigned char>(expression[position + 1]))) {
+    return true;
+  }
+  c = static_cast<char>(std::stoi(expression.substr(position, 2), nullptr, 16));
+  position += 2;
+  return true;
+}
+
+/**
+ * Permet de savoir si un caractère est un opérateur de l'expression
+ */
+static bool is_special(char c) {
+  return std::string("|*+?()[]\\").find(c) != std::string::npos;
+}
+
+/**
+ * Parse a regular expression
+ *
+ * The syntax supports concatenation, union (|), star (*), plus (+),
+ * optional (?), parentheses and character classes ([abc], [a-z]).
+ * A special character is matched literally when preceded by '\', and
+ * "\xHH" denotes the byte of hexadecimal value HH. Any byte but Epsilon
+ * may appear, so UTF-8 text is matched byte by byte.
+ * The empty expression denotes the empty word.
+ */
+Regex::Regex(const std::string& expression) {
+  std::size_t position = 0;
+  tree = parse_union(expression, position);
+
+  // Tout le texte doit avoir été lu
+  if (position != expression.size()) {
+    tree = nullptr;
+  }
+  if (tree == nullptr) {
+    alphabet.clear();
+  }
+}
+
+/**
+ * Tell if the expression was parsed successfully
+ */
+bool Regex::isValid() const { return tree != nullptr; }
+
+/**
+ * Get the root of the syntax tree, or nullptr if the expression is not valid
+ */
+std::shared_ptr<const RegexNode> Regex::root() const { return tree; }
+
+/**
+ * Get the symbols used in the expression
+ */
+const std::set<char>& Regex::symbols() const { return alphabet; }
+
+/**
+ * Permet d'analyser une union de concaténations
+ */
+std::shared_ptr<const RegexNode> Regex::parse_union(
+    const std::string& expression, std::size_t& position) {
+  std::shared_ptr<const RegexNode> result =
+      parse_concatenation(expression, position);
+  while (result != nullptr && position < expression.size() &&
+         expression[position] == '|') {
+    position++;
+    std::shared_ptr<const RegexNode> right =
+        parse_concatenation(expression, position);
+    if (right == nullptr) {
+      return nullptr;
+    }
+    result = make_node(RegexNode::Union, result, right);
+  }
+  return result;
+}
+
+/**
+ * Permet d'analyser une concaténation de répétitions
+ */
+std::shared_ptr<const RegexNode> Regex::parse_concatenation(
+    const std::string& expression, std::size_t& position) {
+  std::shared_ptr<const RegexNode> result = nullptr;
+  while (position < expression.size() && expression[position] != '|' &&
+         expression[position] != ')') {
+    std::shared_ptr<const RegexNode> item =
+        parse_repetition(expression, position);
+    if (item == nullptr) {
+      return nullptr;
+    }
+    result = (result == nullptr)
+                 ? item
+                 : make_node(RegexNode::Concatenation, result, item);
+  }
+
+  // Concaténation vide : le mot vide
+  if (result == nullptr) {
+    result = make_node(RegexNode::EmptyWord);
+  }
+  return result;
+}
+
+/**
+ * Permet d'analyser un élément suivi de ses opérateurs de répétition
+ */
+std::shared_ptr<const RegexNode> Regex::parse_repetition(
+    const std::string& expression, std::size_t& position) {
+  std::shared_ptr<const RegexNode> result = parse_atom(expression, position);
+  while (result != nullptr && position < expression.size()) {
+    char c = expression[position];
+    if (c == '*') {
+      result = make_node(RegexNode::Star, result);
+    } else if (c == '+') {
+      result = make_node(RegexNode::Plus, result);
+    } else if (c == '?') {
+      result = make_node(RegexNode::Optional, result);
+    } else {
+      break;
+    }
+    position++;
+  }
+  return result;
+}
+
+/**
+ * Permet d'analyser un symbole, une classe ou une expression parenthésée
+ */
+std::shared_ptr<const RegexNode> Regex::parse_atom(
+    const std::string& expression, std::size_t& position) {
+  char c = expression[position];
+  position++;
+
+  if (c == '(') {
+    std::shared_ptr<const RegexNode> inner = parse_union(expression, position);
+    if (inner == nullptr || position >= expression.size() ||
+        expression[position] != ')') {
+      return nullptr;
+    }
+    position++;
+    return inner;
+  }
+
+  if (c == '[') {
+    return parse_class(expression, position);
+  }
+
+  if (c == '\\') {
+    if (!read_escaped(expression, position, c)) {
+      return nullptr;
+    }
+  } else if (is_special(c)) {
+    return nullptr;
+  }
+
+  if (!Automaton::isValidSymbol(c)) {
+    return nullptr;
+  }
+  alphabet.insert(c);
+  return std::make_shared<const RegexNode>(
+      RegexNode{RegexNode::Symbols, {c}, nullptr, nullptr});
+}
+
+/**
+ * Permet d'analyser une classe de symboles, après le '['
+ */
+std::shared_ptr<const RegexNode> Regex::parse_class(
+    const std::string& expression, std::size_t& position) {
+  std::set<char> symbols;
+
+  // Lecture d'un symbole de la classe, éventuellement échappé
+  auto read_symbol = [&](char& c) {
+    if (position >= expression.size()) {
+      return false;
+    }
+    c = expression[position];
+    position++;
+    if (c == '\\') {
+      if (!read_escaped(expression, position, c)) {
+        return false;
+      }
+    } else if (c == '[' || c == ']') {
+      return false;
+    }
+    return Automaton::isValidSymbol(c);
+  };
+
+  while (position < expression.size() && expression[position] != ']') {
+    char low;
+    if (!read_symbol(low)) {
+      return nullptr;
+    }
+    char high = low;
+    if (position + 1 < expression.size() && expression[position] == '-' &&
+        expression[position + 1] != ']') {
+      position++;
+      if (!read_symbol(high) ||
+          static_cast<unsigned char>(high) < static_cast<unsigned char>(low)) {
+        return nullptr;
+      }
+    }
+
+    // Les intervalles suivent l'ordre des octets
+    for (int symbol = static_cast<unsigned char>(low);
+         symbol <= static_cast<unsigned char>(high); symbol++) {
+      symbols.insert(static_cast<char>(symbol));
+    }
+  }
+
+  if (position >= expression.size() || symbols.empty()) {
+    return nullptr;
+  }
+  position++;
+
+  alphabet.insert(symbols.begin(), symbols.end());
+  return std::make_shared<const RegexNode>(
+      RegexNode{RegexNode::Symbols, symbols, nullptr, nullptr});
+}
+
+/**
+ * Permet d'ajouter une transition distincte des autres par construction,
+ * sans la chercher parmi les transitions existantes : l'automate doit être
+ * invalidé une fois toutes les transitions ajoutées
+ */
+static void add_new_transition(Automaton& automaton, int from, char symbol, int to) {
+  automaton.set_of_transitions.push_back({from, symbol, to});
+}
+
+/**
+ * Permet d'aplatir une concaténation en la suite de ses facteurs, sans
+ * récursion : une longue chaîne de symboles ne consomme pas la pile
+ */
+static std::vector<const RegexNode*> concatenation_factors(const RegexNode& node) {
+  std::vector<const RegexNode*> factors;
+  std::vector<const RegexNode*> pending = {&node};
+  while (!pending.empty()) {
+    const RegexNode* current = pending.back();
+    pending.pop_back();
+    if (current->kind == RegexNode::Concatenation) {
+      // Le fils gauche est traité en premier
+      pending.push_back(current->right.get());
+      pending.push_back(current->left.get());
+    } else {
+      factors.push_back(current);
+    }
+  }
+  return factors;
+}
+
+/**
+ * Permet de construire le fragment de Thompson d'un noeud, renvoie ses états
+ * d'entrée et de sortie
+ */
+static std::pair<int, int> build_thompson(const RegexNode& node,
+                                          Automaton& automaton) {
+  int begin = automaton.countStates();
+  automaton.addState(begin);
+
+  // Les fragments des facteurs sont chaînés par des epsilon-transitions
+  if (node.kind == RegexNode::Concatenation) {
+    int end = begin;
+    for (const RegexNode* factor : concatenation_factors(node)) {
+      std::pair<int, int> fragment = build_thompson(*factor, automaton);
+      add_new_transition(automaton, end, Epsilon, fragment.first);
+      end = fragment.second;
+    }
+    return {begin, end};
+  }
+
+  std::pair<int, int> left = {-1, -1};
+  std::pair<int, int> right = {-1, -1};
+  if (node.left != nullptr) {
+    left = build_thompson(*node.left, automaton);
+  }
+  if (node.right != nullptr) {
+    right = build_thompson(*node.right, automaton);
+  }
+
+  int end = automaton.countStates();
+  automaton.addState(end);
+
+  switch (node.kind) {
+    case RegexNode::EmptySet:
+      break;
+    case RegexNode::EmptyWord:
+      add_new_transition(automaton, begin, Epsilon, end);
+      break;
+    case RegexNode::Symbols:
+      for (char symbol : node.symbols) {
+        add_new_transition(automaton, begin, symbol, end);
+      }
+      break;
+    case RegexNode::Union:
+      add_new_transition(automaton, begin, Epsilon, left.first);
+      add_new_transition(automaton, begin, Epsilon, right.first);
+      add_new_transition(automaton, left.second, Epsilon, end);
+      add_new_transition(automaton, right.second, Epsilon, end);
+      break;
+    case RegexNode::Star:
+    case RegexNode::Plus:
+    case RegexNode::Optional:
+      add_new_transition(automaton, begin, Epsilon, left.first);
+      add_new_transition(automaton, left.second, Epsilon, end);
+      if (node.kind != RegexNode::Plus) {
+        add_new_transition(automaton, begin, Epsilon, end);
+      }
+      if (node.kind != RegexNode::Optional) {
+        add_new_transition(automaton, left.second, Epsilon, left.first);
+      }
+      break;
+    case RegexNode::Concatenation:
+      break;
+  }
+  return {begin, end};
+}
+
+/**
+ * Permet de construire l'automate de Thompson
+ */
+Automaton Regex::create_thompson() const {
+  Automaton automaton;
+  for (char symbol : alphabet) {
+    automaton.addSymbol(symbol);
+  }
+  std::pair<int, int> fragment = build_thompson(*tree, automaton);
+  automaton.setStateInitial(fragment.first);
+  automaton.setStateFinal(fragment.second);
+  return automaton;
+}
+
+//Structure des ensembles calculés pour un noeud par la construction de Glushkov
+struct GlushkovSets {
+  bool nullable;
+  std::set<int> first;
+  std::set<int> last;
+};
+
+/**
+ * Permet de calculer les ensembles de Glushkov d'un noeud, en numérotant ses
+ * positions et en complétant les ensembles des positions suivantes
+ */
+static GlushkovSets build_glushkov(
+    const RegexNode& node, std::vector<const std::set<char>*>& positions,
+    std::vector<std::set<int>>& follow) {
+  switch (node.kind) {
+    case RegexNode::EmptySet:
+      return {false, {}, {}};
+
+    case RegexNode::EmptyWord:
+      return {true, {}, {}};
+
+    case RegexNode::Symbols: {
+      int position = positions.size();
+      positions.push_back(&node.symbols);
+      follow.emplace_back();
+      return {false, {position}, {position}};
+    }
+
+    case RegexNode::Concatenation: {
+      // Les facteurs sont ajoutés un à un à la concaténation des précédents
+      GlushkovSets result = {true, {}, {}};
+      for (const RegexNode* factor : concatenation_factors(node)) {
+        GlushkovSets right = build_glushkov(*factor, positions, follow);
+        for (int position : result.last) {
+          follow[position].insert(right.first.begin(), right.first.end());
+        }
+        if (result.nullable) {
+          result.first.insert(right.first.begin(), right.first.end());
+        }
+        if (right.nullable) {
+          result.last.insert(right.last.begin(), right.last.end());
+        } else {
+          result.last = std::move(right.last);
+        }
+        result.nullable = result.nullable && right.nullable;
+      }
+      return result;
+    }
+
+    case RegexNode::Union: {
+      GlushkovSets left = build_glushkov(*node.left, positions, follow);
+      GlushkovSets right = build_glushkov(*node.right, positions, follow);
+      left.nullable = left.nullable || right.nullable;
+      left.first.insert(right.first.begin(), right.first.end());
+      left.last.insert(right.last.begin(), right.last.end());
+      return left;
+    }
+
+    case RegexNode::Star:
+    case RegexNode::Plus:
+    case RegexNode::Optional: {
+      GlushkovSets inner = build_glushkov(*node.left, positions, follow);
+      if (node.kind != RegexNode::Optional) {
+        for (int position : inner.last) {
+          follow[position].insert(inner.first.begin(), inner.first.end());
+        }
+      }
+      if (node.kind != RegexNode::Plus) {
+        inner.nullable = true;
+      }
+      return inner;
+    }
+  }
+  return {false, {}, {}};
+}
+
+/**
+ * Permet de construire l'automate de Glushkov
+ */
+Automaton Regex::create_glushkov() const {
+  // La position 0 est l'état initial
+  std::vector<const std::set<char>*> positions = {nullptr};
+  std::vector<std::set<int>> follow(1);
+  GlushkovSets sets = build_glushkov(*tree, positions, follow);
+
+  Automaton automaton;
+  for (char symbol : alphabet) {
+    automaton.addSymbol(symbol);
+  }
+  for (std::size_t position = 0; position < positions.size(); position++) {
+    automaton.addState(position);
+  }
+  automaton.setStateInitial(0);
+  if (sets.nullable) {
+    automaton.setStateFinal(0);
+  }
+  for (int position : sets.last) {
+    automaton.setStateFinal(position);
+  }
+
+  // On entre dans une position en lisant l'un de ses symboles
+  follow[0] = sets.first;
+  for (std::size_t from = 0; from < positions.size(); from++) {
+    for (int to : follow[from]) {
+      for (char symbol : *positions[to]) {
+        add_new_transition(automaton, from, symbol, to);
+      }
+    }
+  }
+  automaton.invalidate();
+  return automaton;
+}
+
+//Structure d'un terme des dérivées, dont les fils sont des numéros de termes
+struct DerivativeTerm {
+  RegexNode::Kind kind;
+  std::set<char> symbols;
+  int left;
+  int right;
+
+  bool operator<(const DerivativeTerm& other) const {
+    return std::tie(kind, symbols, left, right) <
+           std::tie(other.kind, other.symbols, other.left, other.right);
+  }
+};
+
+/**
+ * Ensemble de termes partagés : deux termes égaux après normalisation ont le
+ * même numéro, ce qui garantit un nombre fini de dérivées distinctes
+ */
+class DerivativeTerms {
+public:
+  DerivativeTerms() {
+    empty_set = intern({RegexNode::EmptySet, {}, -1, -1});
+    empty_word = intern({RegexNode::EmptyWord, {}, -1, -1});
+  }
+
+  int empty_set;
+  int empty_word;
+
+  /**
+   * Permet d'obtenir le terme d'un noeud de l'arbre syntaxique
+   */
+  int from_node(const RegexNode& node) {
+    switch (node.kind) {
+      case RegexNode::EmptySet:
+        return empty_set;
+      case RegexNode::EmptyWord:
+        return empty_word;
+      case RegexNode::Symbols:
+        return symbols(node.symbols);
+      case RegexNode::Concatenation: {
+        // Associée à droite en partant du dernier facteur, en temps linéaire
+        std::vector<const RegexNode*> factors = concatenation_factors(node);
+        int result = empty_word;
+        for (auto it = factors.rbegin(); it != factors.rend(); ++it) {
+          result = concatenation(from_node(**it), result);
+        }
+        return result;
+      }
+      case RegexNode::Union:
+        return alternative(from_node(*node.left), from_node(*node.right));
+      case RegexNode::Star:
+        return star(from_node(*node.left));
+      case RegexNode::Plus: {
+        int inner = from_node(*node.left);
+        return concatenation(inner, star(inner));
+      }
+      case RegexNode::Optional:
+        return alternative(empty_word, from_node(*node.left));
+    }
+    return empty_set;
+  }
+
+  /**
+   * Permet de savoir si le terme reconnait le mot vide
+   */
+  bool nullable(int term) const { return nullable_terms[term]; }
+
+  /**
+   * Permet d'obtenir la dérivée du terme par rapport au symbole
+   */
+  int derivative(int term, char symbol) {
+    auto it = derivatives.find({term, symbol});
+    if (it != derivatives.end()) {
+      return it->second;
+    }
+
+    DerivativeTerm t = terms[term];
+    int result = empty_set;
+    switch (t.kind) {
+      case RegexNode::Symbols:
+        if (t.symbols.count(symbol) > 0) {
+          result = empty_word;
+        }
+        break;
+      case RegexNode::Concatenation: {
+        // Parcours de la chaîne tant que les facteurs reconnaissent le mot vide
+        int current = term;
+        while (terms[current].kind == RegexNode::Concatenation) {
+          int left = terms[current].left;
+          int right = terms[current].right;
+          result = alternative(result,
+                               concatenation(derivative(left, symbol), right));
+          if (!nullable(left)) {
+            break;
+          }
+          current = right;
+        }
+        if (terms[current].kind != RegexNode::Concatenation) {
+          result = alternative(result, derivative(current, symbol));
+        }
+        break;
+      }
+      case RegexNode::Union:
+        result = alternative(derivative(t.left, symbol),
+                             derivative(t.right, symbol));
+        break;
+      case RegexNode::Star:
+        result = concatenation(derivative(t.left, symbol), term);
+        break;
+      default:
+        break;
+    }
+
+    derivatives.insert({{term, symbol}, result});
+    return result;
+  }
+
+private:
+  std::vector<DerivativeTerm> terms;
+  std::vector<bool> nullable_terms;
+  std::map<DerivativeTerm, int> numbers;
+  std::map<std::pair<int, char>, int> derivatives;
+
+  /**
+   * Permet d'obtenir le numéro unique d'un terme déjà normalisé
+   */
+  int intern(const DerivativeTerm& term) {
+    auto it = numbers.find(term);
+    if (it != numbers.end()) {
+      return it->second;
+    }
+    int number = terms.size();
+    terms.push_back(term);
+    numbers.insert({term, number});
+
+    // Les fils sont toujours créés avant leur père
+    bool is_nullable = false;
+    switch (term.kind) {
+      case RegexNode::EmptyWord:
+      case RegexNode::Star:
+        is_nullable = true;
+        break;
+      case RegexNode::Concatenation:
+        is_nullable = nullable_terms[term.left] && nullable_terms[term.right];
+        break;
+      case RegexNode::Union:
+        is_nullable = nullable_terms[term.left] || nullable_terms[term.right];
+        break;
+      default:
+        break;
+    }
+    nullable_terms.push_back(is_nullable);
+    return number;
+  }
+
+  int symbols(const std::set<char>& symbol_set) {
+    return intern({RegexNode::Symbols, symbol_set, -1, -1});
+  }
+
+  /**
+   * Concaténation : ∅ absorbant, ε neutre, associée à droite
+   */
+  int concatenation(int left, int right) {
+    if (left == empty_set || right == empty_set) {
+      return empty_set;
+    }
+    if (left == empty_word) {
+      return right;
+    }
+    if (right == empty_word) {
+      return left;
+    }
+    if (terms[left].kind != RegexNode::Concatenation) {
+      return intern({RegexNode::Concatenation, {}, left, right});
+    }
+
+    // Les facteurs de gauche sont rattachés un à un, du dernier au premier
+    std::vector<int> factors;
+    for (int current = left; current != -1;) {
+      if (terms[current].kind == RegexNode::Concatenation) {
+        factors.push_back(terms[current].left);
+        current = terms[current].right;
+      } else {
+        factors.push_back(current);
+        current = -1;
+      }
+    }
+    int result = right;
+    for (auto it = factors.rbegin(); it != factors.rend(); ++it) {
+      result = intern({RegexNode::Concatenation, {}, *it, result});
+    }
+    return result;
+  }
+
+  /**
+   * Permet d'aplatir une union en ses membres, en regroupant les symboles
+   */
+  void collect_union(int term, std::set<int>& members,
+                     std::set<char>& symbol_set) const {
+    const DerivativeTerm& t = terms[term];
+    if (t.kind == RegexNode::Union) {
+      collect_union(t.left, members, symbol_set);
+      collect_union(t.right, members, symbol_set);
+    } else if (t.kind == RegexNode::Symbols) {
+      symbol_set.insert(t.symbols.begin(), t.symbols.end());
+    } else if (term != empty_set) {
+      members.insert(term);
+    }
+  }
+
+  /**
+   * Union : associative, commutative et idempotente, ∅ neutre
+   */
+  int alternative(int left, int right) {
+    std::set<int> members;
+    std::set<char> symbol_set;
+    collect_union(left, members, symbol_set);
+    collect_union(right, members, symbol_set);
+    if (!symbol_set.empty()) {
+      members.insert(symbols(symbol_set));
+    }
+    if (members.empty()) {
+      return empty_set;
+    }
+
+    // Membres triés par numéro, imbriqués à droite
+    auto it = members.rbegin();
+    int result = *it;
+    for (++it; it != members.rend(); ++it) {
+      result = intern({RegexNode::Union, {}, *it, result});
+    }
+    return result;
+  }
+
+  /**
+   * Étoile : (r*)* = r*, ∅* = ε* = ε
+   */
+  int star(int inner) {
+    if (inner == empty_set || inner == empty_word) {
+      return empty_word;
+    }
+    if (terms[inner].kind == RegexNode::Star) {
+      return inner;
+    }
+    return intern({RegexNode::Star, {}, inner, -1});
+  }
+};
+
+/**
+ * Permet de construire l'automate des dérivées de Brzozowski
+ */
+Automaton Regex::create_derivatives() const {
+  DerivativeTerms terms;
+  std::map<int, int> state_of_term;
+  std::vector<int> queue = {terms.from_node(*tree)};
+
+  Automaton automaton;
+  for (char symbol : alphabet) {
+    automaton.addSymbol(symbol);
+  }
+  state_of_term[queue[0]] = 0;
+  automaton.addState(0);
+  automaton.setStateInitial(0);
+
+  // Chaque dérivée distincte est un état
+  for (std::size_t state = 0; state < queue.size(); state++) {
+    int term = queue[state];
+    if (terms.nullable(term)) {
+      automaton.setStateFinal(state);
+    }
+    for (char symbol : alphabet) {
+      int derivative = terms.derivative(term, symbol);
+      auto it = state_of_term.find(derivative);
+      if (it == state_of_term.end()) {
+        it = state_of_term.insert({derivative, queue.size()}).first;
+        automaton.addState(queue.size());
+        queue.push_back(derivative);
+      }
+      add_new_transition(automaton, state, symbol, it->second);
+    }
+  }
+  automaton.invalidate();
+  return automaton;
+}
+
+/**
+ * Create an automaton accepting the language of the expression
+ *
+ * The Thompson automaton has epsilon-transitions, which are not followed
+ * by Automaton::match: use Automaton::createWithoutEpsilon before reading
+ * words. The derivatives construction directly gives a deterministic and
+ * complete automaton, usually close to the minimal one.
+ * If the expression is not valid, the language is empty.
+ */
+Automaton Regex::createAutomaton(RegexConstruction construction) const {
+  Automaton automaton;
+  if (tree == nullptr) {
+    automaton.addState(0);
+    automaton.setStateInitial(0);
+  } else if (construction == RegexConstruction::Thompson) {
+    automaton = create_thompson();
+  } else if (construction == RegexConstruction::Derivatives) {
+    automaton = create_derivatives();
+  } else {
+    automaton = create_glushkov();
+  }
+
+  // On renvoie un automate valide
+  if (automaton.countSymbols() == 0) {
+    automaton.addSymbol('a');
+  }
+  return automaton;
+}
+
+}  // namespace fa
@@ -0,0 +1,127 @@
+
+#ifndef REGEX_H
+#define REGEX_H
+
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "Automaton.h"
+
+namespace fa {
+
+  //Structure d'un noeud de l'arbre syntaxique d'une expression régulière
+  struct RegexNode {
+    enum Kind {
+      EmptySet,      // aucun mot
+      EmptyWord,     // le mot vide
+      Symbols,       // un symbole parmi symbols
+      Concatenation, // left puis right
+      Union,         // left ou right
+      Star,          // left répété 0 fois ou plus
+      Plus,          // left répété 1 fois ou plus
+      Optional       // left ou le mot vide
+    };
+
+    Kind kind;
+    std::set<char> symbols;
+    std::shared_ptr<const RegexNode> left;
+    std::shared_ptr<const RegexNode> right;
+  };
+
+  //Construction utilisée pour passer d'une expression régulière à un automate
+  enum class RegexConstruction {
+    Thompson,   // avec epsilon-transitions
+    Glushkov,   // sans epsilon-transition, un état par symbole de l'expression
+    Derivatives // déterministe et complet, un état par dérivée de Brzozowski
+  };
+
+  class Regex {
+  public:
+    /**
+     * Parse a regular expression
+     *
+     * The syntax supports concatenation, union (|), star (*), plus (+),
+     * optional (?), parentheses and character classes ([abc], [a-z]).
+     * A special character is matched literally when preceded by '\', and
+     * "\xHH" denotes the byte of hexadecimal value HH. Any byte but Epsilon
+     * may appear, so UTF-8 text is matched byte by byte.
+     * The empty expression denotes the empty word.
+     */
+    explicit Regex(const std::string& expression);
+
+    /**
+     * Tell if the expression was parsed successfully
+     */
+    bool isValid() const;
+
+    /**
+     * Get the root of the syntax tree, or nullptr if the expression is not valid
+     */
+    std::shared_ptr<const RegexNode> root() const;
+
+    /**
+     * Get the symbols used in the expression
+     */
+    const std::set<char>& symbols() const;
+
+    /**
+     * Create an automaton accepting the language of the expression
+     *
+     * The Thompson automaton has epsilon-transitions, which are not followed
+     * by Automaton::match: use Automaton::createWithoutEpsilon before reading
+     * words. The derivatives construction directly gives a deterministic and
+     * complete automaton, usually close to the minimal one.
+     * If the expression is not valid, the language is empty.
+     */
+    Automaton createAutomaton(RegexConstruction construction = RegexConstruction::Glushkov) const;
+
+  private:
+    std::shared_ptr<const RegexNode> tree;
+    std::set<char> alphabet;
+
+    /**
+    * Permet d'analyser une union de concaténations
+    */
+    std::shared_ptr<const RegexNode> parse_union(const std::string& expression, std::size_t& position);
+
+    /**
+    * Permet d'analyser une concaténation de répétitions
+    */
+    std::shared_ptr<const RegexNode> parse_concatenation(const std::string& expression, std::size_t& position);
+
+    /**
+    * Permet d'analyser un élément suivi de ses opérateurs de répétition
+    */
+    std::shared_ptr<const RegexNode> parse_repetition(const std::string& expression, std::size_t& position);
+
+    /**
+    * Permet d'analyser un symbole, une classe ou une expression parenthésée
+    */
+    std::shared_ptr<const RegexNode> parse_atom(const std::string& expression, std::size_t& position);
+
+    /**
+    * Permet d'analyser une classe de symboles, après le '['
+    */
+    std::shared_ptr<const RegexNode> parse_class(const std::string& expression, std::size_t& position);
+
+    /**
+    * Permet de construire l'automate de Thompson
+    */
+    Automaton create_thompson() const;
+
+    /**
+    * Permet de construire l'automate de Glushkov
+    */
+    Automaton create_glushkov() const;
+
+    /**
+    * Permet de construire l'automate des dérivées de Brzozowski
+    */
+    Automaton create_derivatives() const;
+  };
+
+}
+
+#endif // REGEX_H
@@ -0,0 +1,164 @@
+
+#ifndef STATIC_AUTOMATON_H
+#define STATIC_AUTOMATON_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <type_traits>
+
+#include "Automaton.h"
+
+namespace fa {
+
+  /**
+   * Deterministic automaton whose transition table is built at compile time
+   *
+   * The states are numbered from 0 to NbStates - 1, and every symbol except
+   * Epsilon may be used. A missing transition leads to a dead state. All the
+   * methods are constexpr, so that an automaton declared constexpr costs
+   * nothing at startup and matches words in constant expressions:
+   *
+   *   constexpr fa::StaticAutomaton<3> ab(0, {2}, {{0, 'a', 1}, {1, 'b', 2}});
+   *   static_assert(ab.isValid() && ab.match("ab"));
+   */
+  template <std::size_t NbStates>
+  class StaticAutomaton {
+  public:
+    // Plus petit type entier capable de contenir les états et l'état mort
+    using StateType = std::conditional_t<(NbStates < 128), std::int8_t,
+                        std::conditional_t<(NbStates < 32768), std::int16_t, std::int32_t>>;
+
+    /**
+     * Value of a missing transition in the table
+     */
+    static constexpr StateType Dead = -1;
+
+    /**
+     * Build the table of the automaton
+     *
+     * If a state is out of range, a transition uses Epsilon, or two
+     * transitions leave the same state with the same symbol to different
+     * states, the automaton is not valid.
+     */
+    constexpr StaticAutomaton(int initial, std::initializer_list<int> finals,
+                              std::initializer_list<Transition> transitions)
+        : valid(true), initial_state(0), final_states(), table() {
+      for (auto& row : table) {
+        for (auto& cell : row) {
+          cell = Dead;
+        }
+      }
+
+      if (!has_state(initial)) {
+        valid = false;
+      } else {
+        initial_state = static_cast<StateType>(initial);
+      }
+
+      for (int state : finals) {
+        if (has_state(state)) {
+          final_states[state] = true;
+        } else {
+          valid = false;
+        }
+      }
+
+      for (const Transition& t : transitions) {
+        if (!has_state(t.from) || !has_state(t.to) || t.symbol == Epsilon) {
+          valid = false;
+          continue;
+        }
+        StateType& cell = table[t.from][static_cast<unsigned char>(t.symbol)];
+        if (cell != Dead && cell != t.to) {
+          valid = false;
+        }
+        cell = static_cast<StateType>(t.to);
+      }
+    }
+
+    /**
+     * Tell if the description of the automaton was valid
+     */
+    constexpr bool isValid() const {
+      return valid;
+    }
+
+    /**
+     * Count the number of states
+     */
+    static constexpr std::size_t countStates() {
+      return NbStates;
+    }
+
+    /**
+     * Get the state reached from a state by a symbol, or Dead
+     */
+    constexpr int next(int state, char symbol) const {
+      return table[state][static_cast<unsigned char>(symbol)];
+    }
+
+    /**
+     * Tell if the word is in the language accepted by the automaton
+     */
+    constexpr bool match(std::string_view word) const {
+      int state = initial_state;
+      for (char symbol : word) {
+        state = table[state][static_cast<unsigned char>(symbol)];
+        if (state == Dead) {
+          return false;
+        }
+      }
+      return final_states[state];
+    }
+
+    /**
+     * Build the equivalent Automaton
+     *
+     * The symbols of the alphabet are those used by the transitions.
+     * Symbols which are not valid for Automaton are ignored.
+     */
+    Automaton toAutomaton() const {
+      Automaton automaton;
+      for (std::size_t state = 0; state < NbStates; state++) {
+        automaton.addState(state);
+        if (final_states[state]) {
+          automaton.setStateFinal(state);
+        }
+      }
+      automaton.setStateInitial(initial_state);
+      for (std::size_t state = 0; state < NbStates; state++) {
+        for (std::size_t symbol = 0; symbol < 256; symbol++) {
+          if (table[state][symbol] != Dead) {
+            automaton.addSymbol(static_cast<char>(symbol));
+            automaton.addTransition(state, static_cast<char>(symbol), table[state][symbol]);
+          }
+        }
+      }
+
+      // On renvoie un automate valide
+      if (automaton.countSymbols() == 0) {
+        automaton.addSymbol('a');
+      }
+      return automaton;
+    }
+
+  private:
+    bool valid;
+    StateType initial_state;
+    std::array<bool, NbStates> final_states;
+    std::array<std::array<StateType, 256>, NbStates> table; // [état][symbole]
+
+    /**
+    * Permet de savoir si un numéro d'état est valide
+    */
+    static constexpr bool has_state(int state) {
+      return state >= 0 && static_cast<std::size_t>(state) < NbStates;
+    }
+  };
+
+}
+
+#endif // STATIC_AUTOMATON_H
@@ -0,0 +1,31 @@
+# Generate a C++ matching function from a regular expression at build time
+#
+#   fa_generate_matcher(<output>
+#     FUNCTION <function_name>
+#     REGEX <regex>
+#     [STYLE switch|goto]
+#   )
+#
+# The output header declares
+#   inline bool <function_name>(const char* text, std::size_t length)
+# Add the output to the sources of a target so that it is generated.
+function(fa_generate_matcher OUTPUT)
+  cmake_parse_arguments(FA "" "FUNCTION;REGEX;STYLE" "" ${ARGN})
+  if(NOT FA_FUNCTION OR NOT DEFINED FA_REGEX)
+    message(FATAL_ERROR "fa_generate_matcher: FUNCTION and REGEX are required")
+  endif()
+  if(NOT FA_STYLE)
+    set(FA_STYLE switch)
+  endif()
+
+  get_filename_component(OUTPUT_DIRECTORY "${OUTPUT}" DIRECTORY)
+  file(MAKE_DIRECTORY "${OUTPUT_DIRECTORY}")
+
+  add_custom_command(
+    OUTPUT "${OUTPUT}"
+    COMMAND fagen "${FA_FUNCTION}" "${FA_REGEX}" "${OUTPUT}" "${FA_STYLE}"
+    DEPENDS fagen
+    COMMENT "Generating ${FA_FUNCTION} from ${FA_REGEX}"
+    VERBATIM
+  )
+endfunction()
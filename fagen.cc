@@ -0,0 +1,44 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "Automaton.h"
+#include "Regex.h"
+
+/**
+ * Generate a C++ matching function from a regular expression
+ *
+ * Usage: fagen <function_name> <regex> <output> [switch|goto]
+ */
+int main(int argc, char** argv) {
+  if (argc != 4 && argc != 5) {
+    std::cerr << "Usage: " << argv[0]
+              << " <function_name> <regex> <output> [switch|goto]\n";
+    return 1;
+  }
+
+  fa::CodeStyle style = fa::CodeStyle::Switch;
+  if (argc == 5) {
+    if (std::strcmp(argv[4], "goto") == 0) {
+      style = fa::CodeStyle::Goto;
+    } else if (std::strcmp(argv[4], "switch") != 0) {
+      std::cerr << "Unknown style: " << argv[4] << '\n';
+      return 1;
+    }
+  }
+
+  fa::Regex regex(argv[2]);
+  if (!regex.isValid()) {
+    std::cerr << "Invalid regular expression: " << argv[2] << '\n';
+    return 1;
+  }
+
+  std::ofstream output(argv[3]);
+  if (!output) {
+    std::cerr << "Cannot write " << argv[3] << '\n';
+    return 1;
+  }
+  regex.createAutomaton().cppPrint(output, argv[1], style);
+  return output ? 0 : 1;
+}
@@ -1,6 +1,21 @@
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory_resource>
+#include <set>
+#include <sstream>
+#include <thread>
+
 #include "Automaton.h"
+#include "Parser.h"
+#include "RangeAutomaton.h"
+#include "Regex.h"
+#include "StaticAutomaton.h"
+#include "identifier_goto.h"
+#include "identifier_switch.h"
 
 /**
 * isValid
@@ -48,8 +63,13 @@ TEST(AutomatonAddTest, TwoSymbol) {
 
 TEST(AutomatonAddTest, NoGraphicRepresentation) {
   fa::Automaton fa;
-  EXPECT_FALSE(fa.addSymbol('\n'));
-  EXPECT_FALSE(fa.hasSymbol('\n'));
+  EXPECT_TRUE(fa.addSymbol('\n'));
+  EXPECT_TRUE(fa.addSymbol(' '));
+  EXPECT_TRUE(fa.addSymbol('\x80'));
+  EXPECT_TRUE(fa.addSymbol('\xff'));
+  EXPECT_TRUE(fa.hasSymbol('\n'));
+  EXPECT_TRUE(fa.hasSymbol('\xff'));
+  EXPECT_EQ(4u, fa.countSymbols());
 }
 
 TEST(AutomatonAddTest, Epsilon) {
@@ -2826,6 +2846,160 @@ TEST(AutomatonCreateMinimalMooreTest, InitialAndFinalState) {
 
 
 
+/**
+ * createMinimalMooreParallel
+*/
+
+TEST(AutomatonCreateMinimalMooreParallelTest, AlreadyMinimal) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addState(2);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addTransition(0,'b',0);
+  fa.addTransition(0,'a',1);
+  fa.addTransition(1,'b',1);
+  fa.addTransition(1,'a',2);
+  fa.addTransition(2,'a',2);
+  fa.addTransition(2,'b',0);
+  fa = fa.createMinimalMooreParallel(fa, 4);
+  EXPECT_TRUE(fa.match("a"));
+  EXPECT_TRUE(fa.match("bbbba"));
+  EXPECT_TRUE(fa.match("abbbaabbabaaabbba"));
+  EXPECT_FALSE(fa.match("aa"));
+  EXPECT_EQ(2u, fa.countSymbols());
+  EXPECT_EQ(3u, fa.countStates());
+  EXPECT_TRUE(fa.isComplete());
+  EXPECT_TRUE(fa.isDeterministic());
+}
+
+TEST(AutomatonCreateMinimalMooreParallelTest, TwoFinalStates) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addState(2);
+  fa.addState(3);
+  fa.addState(4);
+  fa.addState(5);
+  fa.setStateInitial(0);
+  fa.setStateFinal(3);
+  fa.setStateFinal(4);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addTransition(0,'a',1);
+  fa.addTransition(0,'b',2);
+  fa.addTransition(1,'a',2);
+  fa.addTransition(1,'b',3);
+  fa.addTransition(2,'b',4);
+  fa.addTransition(2,'a',1);
+  fa.addTransition(3,'b',5);
+  fa.addTransition(3,'a',4);
+  fa.addTransition(4,'a',3);
+  fa.addTransition(4,'b',5);
+  fa.addTransition(5,'a',5);
+  fa.addTransition(5,'b',5);
+  fa::Automaton moore = fa.createMinimalMoore(fa);
+  fa = fa.createMinimalMooreParallel(fa, 2);
+  EXPECT_TRUE(fa.match("ab"));
+  EXPECT_TRUE(fa.match("baaaabaaa"));
+  EXPECT_TRUE(fa.match("baaaaaaba"));
+  EXPECT_FALSE(fa.match("abb"));
+  EXPECT_EQ(moore.countStates(), fa.countStates());
+  EXPECT_EQ(4u, fa.countStates());
+  EXPECT_TRUE(fa.isComplete());
+  EXPECT_TRUE(fa.isDeterministic());
+}
+
+TEST(AutomatonCreateMinimalMooreParallelTest, NotComplete) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addState(2);
+  fa.addState(3);
+  fa.setStateInitial(0);
+  fa.setStateFinal(3);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addSymbol('c');
+  fa.addTransition(0,'a',1);
+  fa.addTransition(0,'b',2);
+  fa.addTransition(1,'c',3);
+  fa.addTransition(2,'c',3);
+  fa = fa.createMinimalMooreParallel(fa);
+  EXPECT_TRUE(fa.match("ac"));
+  EXPECT_TRUE(fa.match("bc"));
+  EXPECT_FALSE(fa.match("cc"));
+  EXPECT_EQ(4u, fa.countStates());
+  EXPECT_TRUE(fa.isComplete());
+  EXPECT_TRUE(fa.isDeterministic());
+}
+
+TEST(AutomatonCreateMinimalMooreParallelTest, ManyStates) {
+  // Compteur modulo 3000 dont les multiples de 3 sont finaux
+  fa::Automaton fa;
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  for (int i = 0; i < 3000; i++) {
+    fa.addState(i);
+    if (i % 3 == 0) {
+      fa.setStateFinal(i);
+    }
+  }
+  fa.setStateInitial(0);
+  for (int i = 0; i < 3000; i++) {
+    fa.addTransition(i,'a',(i + 1) % 3000);
+    fa.addTransition(i,'b',i);
+  }
+  fa = fa.createMinimalMooreParallel(fa, 4);
+  EXPECT_TRUE(fa.match(""));
+  EXPECT_TRUE(fa.match("ababba"));
+  EXPECT_FALSE(fa.match("aaaa"));
+  EXPECT_EQ(3u, fa.countStates());
+  EXPECT_TRUE(fa.isComplete());
+  EXPECT_TRUE(fa.isDeterministic());
+}
+
+TEST(AutomatonCreateMinimalMooreParallelTest, ReusedWorkers) {
+  // Compteur modulo 7000 dont les multiples de 7 sont finaux, sur quatre tranches
+  fa::Automaton fa;
+  fa.addSymbol('a');
+  for (int i = 0; i < 7000; i++) {
+    fa.addState(i);
+    if (i % 7 == 0) {
+      fa.setStateFinal(i);
+    }
+  }
+  fa.setStateInitial(0);
+  for (int i = 0; i < 7000; i++) {
+    fa.set_of_transitions.push_back({i, 'a', (i + 1) % 7000});
+  }
+  for (int round = 0; round < 3; round++) {
+    fa::Automaton minimal = fa::Automaton::createMinimalMooreParallel(fa, 4);
+    EXPECT_EQ(7u, minimal.countStates());
+    EXPECT_TRUE(minimal.match("aaaaaaa"));
+    EXPECT_FALSE(minimal.match("aaaaaa"));
+  }
+}
+
+TEST(AutomatonCreateMinimalMooreParallelTest, SymbolOutsideAlphabet) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('a');
+  fa.addTransition(0, 'a', 1);
+  fa.set_of_transitions.push_back({1, 'z', 0});
+  fa::Automaton minimal = fa::Automaton::createMinimalMooreParallel(fa, 2);
+  EXPECT_TRUE(minimal.match("a"));
+  EXPECT_FALSE(minimal.match("aa"));
+}
+
+
+
 /**
  * createMinimalBrzozowski
 */
@@ -2975,6 +3149,2362 @@ TEST(AutomatonCreateMinimalBrzozowskiTest, InitialAndFinalState) {
 }
 
 
+/**
+ * BitParallelAutomaton
+*/
+
+TEST(BitParallelAutomatonTest, NonDeterministic) {
+  // Mots se terminant par "ab"
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addState(2);
+  fa.setStateInitial(0);
+  fa.setStateFinal(2);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addTransition(0,'a',0);
+  fa.addTransition(0,'b',0);
+  fa.addTransition(0,'a',1);
+  fa.addTransition(1,'b',2);
+  fa::BitParallelAutomaton bit(fa);
+  EXPECT_TRUE(bit.isValid());
+  EXPECT_TRUE(bit.match("ab"));
+  EXPECT_TRUE(bit.match("bbaab"));
+  EXPECT_FALSE(bit.match("aba"));
+  EXPECT_FALSE(bit.match(""));
+  EXPECT_EQ(std::set<int>({0, 1}), bit.readString("aba"));
+  EXPECT_EQ(std::set<int>({0, 2}), bit.readString("bab"));
+}
+
+TEST(BitParallelAutomatonTest, UnknownSymbol) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.setStateInitial(0);
+  fa.setStateFinal(0);
+  fa.addSymbol('a');
+  fa.addTransition(0,'a',0);
+  fa::BitParallelAutomaton bit(fa);
+  EXPECT_TRUE(bit.match("aaa"));
+  EXPECT_FALSE(bit.match("aba"));
+  EXPECT_TRUE(bit.readString("ab").empty());
+}
+
+TEST(BitParallelAutomatonTest, SymbolOutsideAlphabet) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addTransition(0,'a',1);
+  fa.addTransition(0,'b',1);
+  // Le symbole est retiré de l'alphabet sans retirer sa transition
+  fa.alphabet.erase('b');
+  fa::BitParallelAutomaton bit(fa);
+  EXPECT_TRUE(bit.isValid());
+  EXPECT_TRUE(bit.match("a"));
+  EXPECT_FALSE(bit.match("b"));
+}
+
+TEST(BitParallelAutomatonTest, EpsilonNotFollowed) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('a');
+  fa.addTransition(0,fa::Epsilon,1);
+  fa.addTransition(0,'a',0);
+  fa::BitParallelAutomaton bit(fa);
+  EXPECT_FALSE(bit.match(""));
+  EXPECT_FALSE(bit.match("a"));
+  EXPECT_EQ(fa.readString("aa"), bit.readString("aa"));
+}
+
+TEST(BitParallelAutomatonTest, MaxStates) {
+  // Compteur modulo 64 avec des numéros d'états non contigus
+  fa::Automaton fa;
+  fa.addSymbol('a');
+  for (int i = 0; i < 64; i++) {
+    fa.addState(i * 10);
+  }
+  fa.setStateInitial(0);
+  fa.setStateFinal(630);
+  for (int i = 0; i < 64; i++) {
+    fa.addTransition(i * 10,'a',((i + 1) % 64) * 10);
+  }
+  fa::BitParallelAutomaton bit(fa);
+  EXPECT_TRUE(bit.isValid());
+  EXPECT_TRUE(bit.match(std::string(63, 'a')));
+  EXPECT_TRUE(bit.match(std::string(127, 'a')));
+  EXPECT_FALSE(bit.match(std::string(64, 'a')));
+  EXPECT_EQ(std::set<int>({50}), bit.readString("aaaaa"));
+}
+
+TEST(BitParallelAutomatonTest, TooManyStates) {
+  fa::Automaton fa;
+  fa.addSymbol('a');
+  for (int i = 0; i < 65; i++) {
+    fa.addState(i);
+    fa.addTransition(i,'a',i);
+  }
+  fa.setStateInitial(0);
+  fa.setStateFinal(0);
+  fa::BitParallelAutomaton bit(fa);
+  EXPECT_FALSE(bit.isValid());
+  EXPECT_TRUE(fa.match("aaa"));
+  EXPECT_EQ(std::set<int>({0}), fa.readString("aa"));
+}
+
+
+/**
+ * LazyDeterministicAutomaton
+*/
+
+// Mots dont la n-ième lettre en partant de la fin est un 'a' : le
+// déterminisé complet a 2^n états
+static fa::Automaton nthLastIsA(int n) {
+  fa::Automaton fa;
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  for (int i = 0; i <= n; i++) {
+    fa.addState(i);
+  }
+  fa.setStateInitial(0);
+  fa.setStateFinal(n);
+  fa.addTransition(0,'a',0);
+  fa.addTransition(0,'b',0);
+  fa.addTransition(0,'a',1);
+  for (int i = 1; i < n; i++) {
+    fa.addTransition(i,'a',i + 1);
+    fa.addTransition(i,'b',i + 1);
+  }
+  return fa;
+}
+
+TEST(LazyDeterministicAutomatonTest, SameAsMatch) {
+  fa::Automaton fa = nthLastIsA(3);
+  fa::LazyDeterministicAutomaton lazy(fa);
+  const char* words[] = {"", "a", "abb", "bab", "aaaa", "babba", "abbbabb", "c"};
+  for (const char* word : words) {
+    EXPECT_EQ(fa.match(word), lazy.match(word)) << word;
+  }
+  EXPECT_EQ(0u, lazy.countFlushes());
+}
+
+TEST(LazyDeterministicAutomatonTest, OnlyVisitedStates) {
+  fa::Automaton fa = nthLastIsA(20);
+  fa::LazyDeterministicAutomaton lazy(fa);
+  EXPECT_TRUE(lazy.match("a" + std::string(19, 'b')));
+  EXPECT_FALSE(lazy.match(std::string(20, 'b')));
+  EXPECT_EQ(21u, lazy.countCachedStates());
+  EXPECT_EQ(0u, lazy.countFlushes());
+}
+
+TEST(LazyDeterministicAutomatonTest, BoundedCache) {
+  fa::Automaton fa = nthLastIsA(6);
+  fa::LazyDeterministicAutomaton lazy(fa, 8, 1000);
+  std::string word = "abaabbbaaababbabbbaaab";
+  EXPECT_EQ(fa.match(word), lazy.match(word));
+  EXPECT_EQ(fa.match(word + "bbbbb"), lazy.match(word + "bbbbb"));
+  EXPECT_LE(lazy.countCachedStates(), 8u);
+  EXPECT_LT(0u, lazy.countFlushes());
+}
+
+TEST(LazyDeterministicAutomatonTest, FallbackSimulation) {
+  fa::Automaton fa = nthLastIsA(6);
+  fa::LazyDeterministicAutomaton lazy(fa, 2, 0);
+  EXPECT_TRUE(lazy.match("abbbbbabbbbb"));
+  EXPECT_TRUE(lazy.match("bbbabbbbb"));
+  EXPECT_FALSE(lazy.match("aabbbbbbbb"));
+  EXPECT_FALSE(lazy.match("abababcab"));
+  EXPECT_LE(lazy.countCachedStates(), 2u);
+}
+
+TEST(LazyDeterministicAutomatonTest, SymbolOutsideAlphabet) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addTransition(0,'a',1);
+  fa.addTransition(0,'b',1);
+  // Le symbole est retiré de l'alphabet sans retirer sa transition
+  fa.alphabet.erase('b');
+  fa::LazyDeterministicAutomaton lazy(fa);
+  EXPECT_TRUE(lazy.match("a"));
+  EXPECT_FALSE(lazy.match("b"));
+}
+
+TEST(LazyDeterministicAutomatonTest, NoInitialState) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.setStateFinal(0);
+  fa.addSymbol('a');
+  fa.addTransition(0,'a',0);
+  fa::LazyDeterministicAutomaton lazy(fa);
+  EXPECT_FALSE(lazy.match(""));
+  EXPECT_FALSE(lazy.match("aa"));
+}
+
+
+/**
+ * SubstringSearcher
+*/
+
+TEST(SubstringSearcherTest, LongText) {
+  // Langage {"ab"}
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addState(2);
+  fa.setStateInitial(0);
+  fa.setStateFinal(2);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addTransition(0,'a',1);
+  fa.addTransition(1,'b',2);
+  fa::SubstringSearcher searcher(fa);
+  EXPECT_EQ(1u, searcher.countFirstBytes());
+  EXPECT_TRUE(searcher.matchSubstring("ab"));
+  EXPECT_TRUE(searcher.matchSubstring(std::string(100, 'x') + "aab" + std::string(7, 'y')));
+  EXPECT_TRUE(searcher.matchSubstring(std::string(1000, 'b') + "ab"));
+  EXPECT_FALSE(searcher.matchSubstring(std::string(1000, 'b') + "a"));
+  EXPECT_FALSE(searcher.matchSubstring(std::string(33, 'a') + "cb"));
+  EXPECT_FALSE(searcher.matchSubstring(""));
+}
+
+TEST(SubstringSearcherTest, ManyFirstBytes) {
+  // Langage {"a", "b", "c", "d"} suivis de 'e'
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addState(2);
+  fa.setStateInitial(0);
+  fa.setStateFinal(2);
+  for (char c = 'a'; c <= 'e'; c++) {
+    fa.addSymbol(c);
+  }
+  for (char c = 'a'; c <= 'd'; c++) {
+    fa.addTransition(0,c,1);
+  }
+  fa.addTransition(1,'e',2);
+  fa::SubstringSearcher searcher(fa);
+  EXPECT_EQ(4u, searcher.countFirstBytes());
+  EXPECT_TRUE(searcher.matchSubstring(std::string(50, 'e') + "de"));
+  EXPECT_TRUE(searcher.matchSubstring("xxce"));
+  EXPECT_FALSE(searcher.matchSubstring(std::string(50, 'e') + "dd"));
+}
+
+TEST(SubstringSearcherTest, EmptyWord) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.setStateInitial(0);
+  fa.setStateFinal(0);
+  fa.addSymbol('a');
+  fa::SubstringSearcher searcher(fa);
+  EXPECT_TRUE(searcher.matchSubstring(""));
+  EXPECT_TRUE(searcher.matchSubstring("xyz"));
+}
+
+TEST(SubstringSearcherTest, EmptyLanguage) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.addSymbol('a');
+  fa.addTransition(0,'a',1);
+  fa::SubstringSearcher searcher(fa);
+  EXPECT_FALSE(searcher.matchSubstring(std::string(100, 'a')));
+}
+
+TEST(SubstringSearcherTest, SameAsMatchOnFactors) {
+  // Mots sur {a, b} contenant un nombre pair de 'b', et au moins un 'b'
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addState(2);
+  fa.setStateInitial(0);
+  fa.setStateFinal(2);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addTransition(0,'b',1);
+  fa.addTransition(1,'a',1);
+  fa.addTransition(1,'b',2);
+  fa.addTransition(2,'a',2);
+  fa.addTransition(2,'b',1);
+  fa::SubstringSearcher searcher(fa);
+  const char* texts[] = {"", "b", "bb", "ab", "abab", "xbxb", "cbacbaac", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabab"};
+  for (std::string text : texts) {
+    bool expected = false;
+    for (std::size_t i = 0; i < text.size(); i++) {
+      for (std::size_t j = i; j <= text.size(); j++) {
+        expected = expected || fa.match(text.substr(i, j - i));
+      }
+    }
+    EXPECT_EQ(expected, searcher.matchSubstring(text)) << text;
+  }
+}
+
+
+/**
+ * search
+*/
+
+TEST(AutomatonSearchTest, LeftmostLongest) {
+  // Langage a b*
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addTransition(0,'a',1);
+  fa.addTransition(1,'b',1);
+  fa::SearchResult result = fa.search("xxabbbaby");
+  EXPECT_TRUE(result.found);
+  EXPECT_EQ(2u, result.start);
+  EXPECT_EQ(6u, result.end);
+  result = fa.search(std::string(40, 'b') + "a");
+  EXPECT_TRUE(result.found);
+  EXPECT_EQ(40u, result.start);
+  EXPECT_EQ(41u, result.end);
+}
+
+TEST(AutomatonSearchTest, LeftmostBeforeFirstEnd) {
+  // Langage {"abcd", "c"} : "c" se termine en premier mais "abcd" débute avant
+  fa::Automaton fa;
+  for (int i = 0; i <= 5; i++) {
+    fa.addState(i);
+  }
+  fa.setStateInitial(0);
+  fa.setStateFinal(4);
+  fa.setStateFinal(5);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addSymbol('c');
+  fa.addSymbol('d');
+  fa.addTransition(0,'a',1);
+  fa.addTransition(1,'b',2);
+  fa.addTransition(2,'c',3);
+  fa.addTransition(3,'d',4);
+  fa.addTransition(0,'c',5);
+  fa::SubstringSearcher searcher(fa);
+  fa::SearchResult result = searcher.search("zabcdz");
+  EXPECT_TRUE(result.found);
+  EXPECT_EQ(1u, result.start);
+  EXPECT_EQ(5u, result.end);
+  result = searcher.search("zabczd");
+  EXPECT_TRUE(result.found);
+  EXPECT_EQ(3u, result.start);
+  EXPECT_EQ(4u, result.end);
+}
+
+TEST(AutomatonSearchTest, NotFound) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('a');
+  fa.addTransition(0,'a',1);
+  fa::SearchResult result = fa.search("bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb");
+  EXPECT_FALSE(result.found);
+  EXPECT_FALSE(fa.search("").found);
+}
+
+TEST(AutomatonSearchTest, EmptyWord) {
+  // Langage a*
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.setStateInitial(0);
+  fa.setStateFinal(0);
+  fa.addSymbol('a');
+  fa.addTransition(0,'a',0);
+  fa::SearchResult result = fa.search("aab");
+  EXPECT_TRUE(result.found);
+  EXPECT_EQ(0u, result.start);
+  EXPECT_EQ(2u, result.end);
+  result = fa.search("baa");
+  EXPECT_TRUE(result.found);
+  EXPECT_EQ(0u, result.start);
+  EXPECT_EQ(0u, result.end);
+}
+
+
+/**
+ * MultiPatternAutomaton
+*/
+
+// Automate reconnaissant exactement le mot
+static fa::Automaton wordAutomaton(const std::string& word) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.setStateInitial(0);
+  for (std::size_t i = 0; i < word.size(); i++) {
+    fa.addSymbol(word[i]);
+    fa.addState(i + 1);
+    fa.addTransition(i,word[i],i + 1);
+  }
+  fa.setStateFinal(word.size());
+  return fa;
+}
+
+TEST(MultiPatternAutomatonTest, SeveralMatches) {
+  // Motif 0 : a*, motif 1 : "aa", motif 2 : "ab"
+  fa::Automaton star;
+  star.addState(0);
+  star.setStateInitial(0);
+  star.setStateFinal(0);
+  star.addSymbol('a');
+  star.addTransition(0,'a',0);
+  fa::MultiPatternAutomaton multi({star, wordAutomaton("aa"), wordAutomaton("ab")});
+  EXPECT_EQ(3u, multi.countPatterns());
+  EXPECT_EQ(std::vector<std::size_t>({0, 1}), multi.match("aa"));
+  EXPECT_EQ(std::vector<std::size_t>({0}), multi.match(""));
+  EXPECT_EQ(std::vector<std::size_t>({0}), multi.match("aaa"));
+  EXPECT_EQ(std::vector<std::size_t>({2}), multi.match("ab"));
+  EXPECT_TRUE(multi.match("abc").empty());
+  EXPECT_TRUE(multi.match("b").empty());
+}
+
+TEST(MultiPatternAutomatonTest, ManyPatterns) {
+  std::vector<fa::Automaton> patterns;
+  for (int i = 0; i < 100; i++) {
+    patterns.push_back(wordAutomaton(std::to_string(i)));
+  }
+  fa::MultiPatternAutomaton multi(patterns);
+  EXPECT_EQ(100u, multi.countPatterns());
+  EXPECT_EQ(std::vector<std::size_t>({7}), multi.match("7"));
+  EXPECT_EQ(std::vector<std::size_t>({42}), multi.match("42"));
+  EXPECT_EQ(std::vector<std::size_t>({99}), multi.match("99"));
+  EXPECT_TRUE(multi.match("100").empty());
+  EXPECT_EQ(101u, multi.countStates());
+}
+
+TEST(MultiPatternAutomatonTest, NonDeterministicPattern) {
+  // Mots se terminant par 'a', et mots commençant par 'a'
+  fa::Automaton ends;
+  ends.addState(0);
+  ends.addState(1);
+  ends.setStateInitial(0);
+  ends.setStateFinal(1);
+  ends.addSymbol('a');
+  ends.addSymbol('b');
+  ends.addTransition(0,'a',0);
+  ends.addTransition(0,'b',0);
+  ends.addTransition(0,'a',1);
+  fa::Automaton begins;
+  begins.addState(0);
+  begins.addState(1);
+  begins.setStateInitial(0);
+  begins.setStateFinal(1);
+  begins.addSymbol('a');
+  begins.addSymbol('b');
+  begins.addTransition(0,'a',1);
+  begins.addTransition(1,'a',1);
+  begins.addTransition(1,'b',1);
+  fa::MultiPatternAutomaton multi({ends, begins});
+  EXPECT_EQ(std::vector<std::size_t>({0, 1}), multi.match("aba"));
+  EXPECT_EQ(std::vector<std::size_t>({0}), multi.match("bba"));
+  EXPECT_EQ(std::vector<std::size_t>({1}), multi.match("abb"));
+  EXPECT_TRUE(multi.match("bab").empty());
+}
+
+TEST(MultiPatternAutomatonTest, NoPattern) {
+  fa::MultiPatternAutomaton multi({});
+  EXPECT_EQ(0u, multi.countPatterns());
+  EXPECT_TRUE(multi.match("").empty());
+  EXPECT_TRUE(multi.match("a").empty());
+}
+
+
+/**
+ * createAhoCorasick
+*/
+
+TEST(AutomatonCreateAhoCorasickTest, Classic) {
+  fa::Automaton fa = fa::Automaton::createAhoCorasick({"he", "she", "his", "hers"});
+  EXPECT_TRUE(fa.isDeterministic());
+  EXPECT_TRUE(fa.isComplete());
+  EXPECT_EQ(10u, fa.countStates());
+  EXPECT_EQ(5u, fa.countSymbols());
+  EXPECT_TRUE(fa.match("he"));
+  EXPECT_TRUE(fa.match("rshe"));
+  EXPECT_TRUE(fa.match("shis"));
+  EXPECT_TRUE(fa.match("hhers"));
+  EXPECT_FALSE(fa.match("hes"));
+  EXPECT_FALSE(fa.match("sh"));
+  EXPECT_FALSE(fa.match(""));
+}
+
+TEST(AutomatonCreateAhoCorasickTest, KeywordSuffixOfAnother) {
+  fa::Automaton fa = fa::Automaton::createAhoCorasick({"abcd", "bc"});
+  EXPECT_TRUE(fa.match("abc"));
+  EXPECT_TRUE(fa.match("aabcd"));
+  EXPECT_FALSE(fa.match("abcda"));
+  EXPECT_TRUE(fa.match("abcdbc"));
+}
+
+TEST(AutomatonCreateAhoCorasickTest, EmptyKeyword) {
+  fa::Automaton fa = fa::Automaton::createAhoCorasick({"", "ab"});
+  EXPECT_TRUE(fa.match(""));
+  EXPECT_TRUE(fa.match("ba"));
+  EXPECT_TRUE(fa.match("bbb"));
+}
+
+TEST(AutomatonCreateAhoCorasickTest, InvalidKeyword) {
+  fa::Automaton fa = fa::Automaton::createAhoCorasick({std::string("a\0b", 3), std::string(1, fa::Epsilon)});
+  EXPECT_TRUE(fa.isValid());
+  EXPECT_EQ(1u, fa.countStates());
+  EXPECT_TRUE(fa.isLanguageEmpty());
+}
+
+TEST(AutomatonCreateAhoCorasickTest, SameAsSubstringSearch) {
+  std::vector<std::string> keywords = {"ab", "bba", "aaa"};
+  fa::Automaton fa = fa::Automaton::createAhoCorasick(keywords);
+  const char* texts[] = {"", "a", "ab", "bab", "bbba", "baab", "aabba", "bbaaab", "babab"};
+  for (std::string text : texts) {
+    for (std::size_t end = 0; end <= text.size(); end++) {
+      std::string prefix = text.substr(0, end);
+      bool expected = false;
+      for (auto& keyword : keywords) {
+        expected = expected || (prefix.size() >= keyword.size() &&
+                                prefix.compare(prefix.size() - keyword.size(), keyword.size(), keyword) == 0);
+      }
+      EXPECT_EQ(expected, fa.match(prefix)) << prefix;
+    }
+  }
+}
+
+
+/**
+ * MinimalAcyclicBuilder
+*/
+
+TEST(MinimalAcyclicBuilderTest, SharedSuffixes) {
+  fa::MinimalAcyclicBuilder builder;
+  EXPECT_TRUE(builder.addWord("tap"));
+  EXPECT_TRUE(builder.addWord("taps"));
+  EXPECT_TRUE(builder.addWord("top"));
+  EXPECT_TRUE(builder.addWord("tops"));
+  fa::Automaton fa = builder.createAutomaton();
+  EXPECT_EQ(5u, fa.countStates());
+  EXPECT_EQ(5u, fa.countTransitions());
+  EXPECT_TRUE(fa.isDeterministic());
+  EXPECT_TRUE(fa.match("tap"));
+  EXPECT_TRUE(fa.match("tops"));
+  EXPECT_FALSE(fa.match("ta"));
+  EXPECT_FALSE(fa.match("topss"));
+  EXPECT_EQ(fa.createMinimalMoore(fa).countStates(), fa.countStates() + 1);
+}
+
+TEST(MinimalAcyclicBuilderTest, NotSorted) {
+  fa::MinimalAcyclicBuilder builder;
+  EXPECT_TRUE(builder.addWord("b"));
+  EXPECT_FALSE(builder.addWord("a"));
+  EXPECT_FALSE(builder.addWord("b"));
+  EXPECT_FALSE(builder.addWord(std::string("c\0d", 3)));
+  EXPECT_TRUE(builder.addWord("c"));
+  fa::Automaton fa = builder.createAutomaton();
+  EXPECT_TRUE(fa.match("b"));
+  EXPECT_TRUE(fa.match("c"));
+  EXPECT_FALSE(fa.match("a"));
+  EXPECT_EQ(2u, fa.countStates());
+}
+
+TEST(MinimalAcyclicBuilderTest, EmptyWord) {
+  fa::MinimalAcyclicBuilder builder;
+  EXPECT_TRUE(builder.addWord(""));
+  EXPECT_TRUE(builder.addWord("a"));
+  fa::Automaton fa = builder.createAutomaton();
+  EXPECT_TRUE(fa.match(""));
+  EXPECT_TRUE(fa.match("a"));
+  EXPECT_FALSE(fa.match("aa"));
+}
+
+TEST(MinimalAcyclicBuilderTest, NoWord) {
+  fa::MinimalAcyclicBuilder builder;
+  fa::Automaton fa = builder.createAutomaton();
+  EXPECT_TRUE(fa.isValid());
+  EXPECT_TRUE(fa.isLanguageEmpty());
+}
+
+TEST(MinimalAcyclicBuilderTest, StaysMinimal) {
+  // Tous les nombres de trois chiffres : 4 états une fois minimal
+  fa::MinimalAcyclicBuilder builder;
+  for (int i = 0; i < 1000; i++) {
+    std::string word = std::to_string(1000 + i).substr(1);
+    EXPECT_TRUE(builder.addWord(word));
+    EXPECT_LE(builder.countStates(), 7u);
+  }
+  fa::Automaton fa = builder.createAutomaton();
+  EXPECT_EQ(4u, fa.countStates());
+  EXPECT_EQ(30u, fa.countTransitions());
+  EXPECT_TRUE(fa.match("042"));
+  EXPECT_FALSE(fa.match("42"));
+  // Le constructeur reste utilisable après création de l'automate
+  EXPECT_TRUE(builder.addWord("9990"));
+  EXPECT_TRUE(builder.createAutomaton().match("9990"));
+}
+
+TEST(MinimalAcyclicBuilderTest, MinimalAfterEachWord) {
+  // Le chemin du dernier mot est minimisé sans modifier le constructeur
+  fa::MinimalAcyclicBuilder builder;
+  for (const char* word : {"bat", "bats", "cat", "cats", "do", "dog", "dogs", "fat"}) {
+    EXPECT_TRUE(builder.addWord(word));
+    fa::Automaton fa = builder.createAutomaton();
+    EXPECT_TRUE(fa.match(word));
+    EXPECT_EQ(fa::Automaton::createMinimalMoore(fa).countStates(), fa.countStates() + 1)
+        << word;
+  }
+  fa::Automaton fa = builder.createAutomaton();
+  EXPECT_TRUE(fa.match("cats"));
+  EXPECT_TRUE(fa.match("do"));
+  EXPECT_FALSE(fa.match("dot"));
+  EXPECT_FALSE(fa.match("fats"));
+}
+
+
+/**
+ * createWithoutEpsilon
+*/
+
+TEST(AutomatonCreateWithoutEpsilonTest, Chain) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addState(2);
+  fa.setStateInitial(0);
+  fa.setStateFinal(2);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addTransition(0,fa::Epsilon,1);
+  fa.addTransition(1,'a',1);
+  fa.addTransition(1,fa::Epsilon,2);
+  fa.addTransition(2,'b',2);
+  fa = fa.createWithoutEpsilon(fa);
+  EXPECT_FALSE(fa.hasEpsilonTransition());
+  EXPECT_EQ(3u, fa.countStates());
+  EXPECT_TRUE(fa.match(""));
+  EXPECT_TRUE(fa.match("aab"));
+  EXPECT_TRUE(fa.match("bb"));
+  EXPECT_FALSE(fa.match("ba"));
+}
+
+TEST(AutomatonCreateWithoutEpsilonTest, Cycle) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('a');
+  fa.addTransition(0,fa::Epsilon,1);
+  fa.addTransition(1,fa::Epsilon,0);
+  fa.addTransition(1,'a',1);
+  fa = fa.createWithoutEpsilon(fa);
+  EXPECT_FALSE(fa.hasEpsilonTransition());
+  EXPECT_TRUE(fa.match(""));
+  EXPECT_TRUE(fa.match("aaa"));
+}
+
+TEST(AutomatonCreateWithoutEpsilonTest, NoEpsilon) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('a');
+  fa.addTransition(0,'a',1);
+  fa::Automaton result = fa.createWithoutEpsilon(fa);
+  EXPECT_EQ(fa.countStates(), result.countStates());
+  EXPECT_EQ(fa.countTransitions(), result.countTransitions());
+  EXPECT_TRUE(result.hasTransition(0,'a',1));
+}
+
+/**
+ * Regex
+*/
+
+// Vérifie les deux constructions sur une liste de mots
+static void expectRegexLanguage(const std::string& expression,
+                                const std::vector<std::string>& accepted,
+                                const std::vector<std::string>& rejected) {
+  fa::Regex regex(expression);
+  ASSERT_TRUE(regex.isValid()) << expression;
+  fa::Automaton glushkov = regex.createAutomaton(fa::RegexConstruction::Glushkov);
+  fa::Automaton thompson = regex.createAutomaton(fa::RegexConstruction::Thompson);
+  fa::Automaton derivatives = regex.createAutomaton(fa::RegexConstruction::Derivatives);
+  EXPECT_FALSE(glushkov.hasEpsilonTransition());
+  EXPECT_TRUE(derivatives.isDeterministic());
+  thompson = thompson.createWithoutEpsilon(thompson);
+  for (auto& word : accepted) {
+    EXPECT_TRUE(glushkov.match(word)) << expression << " / " << word;
+    EXPECT_TRUE(thompson.match(word)) << expression << " / " << word;
+    EXPECT_TRUE(derivatives.match(word)) << expression << " / " << word;
+  }
+  for (auto& word : rejected) {
+    EXPECT_FALSE(glushkov.match(word)) << expression << " / " << word;
+    EXPECT_FALSE(thompson.match(word)) << expression << " / " << word;
+    EXPECT_FALSE(derivatives.match(word)) << expression << " / " << word;
+  }
+}
+
+TEST(RegexTest, Operators) {
+  expectRegexLanguage("ab", {"ab"}, {"", "a", "abb"});
+  expectRegexLanguage("a|bc", {"a", "bc"}, {"", "ab", "abc"});
+  expectRegexLanguage("(ab)*", {"", "ab", "abab"}, {"a", "aba"});
+  expectRegexLanguage("a+b?", {"a", "aaa", "aab"}, {"", "b", "abb"});
+  expectRegexLanguage("(a|b)*abb", {"abb", "babb", "aababb"}, {"ab", "abba"});
+  expectRegexLanguage("", {""}, {"a"});
+  expectRegexLanguage("a()b", {"ab"}, {"a", "b"});
+}
+
+TEST(RegexTest, Classes) {
+  expectRegexLanguage("[a-c]x", {"ax", "bx", "cx"}, {"dx", "x"});
+  expectRegexLanguage("[0-9]+", {"0", "42", "1234567890"}, {"", "4a"});
+  expectRegexLanguage("[ab-]", {"a", "b", "-"}, {"c"});
+  expectRegexLanguage("\\(\\*\\)", {"(*)"}, {"", "*"});
+  expectRegexLanguage("[\\]]", {"]"}, {"\\"});
+}
+
+TEST(RegexTest, Glushkov) {
+  fa::Regex regex("(a|b)*abb");
+  fa::Automaton fa = regex.createAutomaton();
+  EXPECT_EQ(6u, fa.countStates());
+  EXPECT_EQ(2u, fa.countSymbols());
+  EXPECT_FALSE(fa.hasEpsilonTransition());
+}
+
+TEST(RegexTest, Derivatives) {
+  const char* expressions[] = {"(a|b)*abb", "(ab|a)*", "a*b*a*", "((a|b)(a|b))*", "[a-c]+|c*"};
+  for (const char* expression : expressions) {
+    fa::Regex regex(expression);
+    fa::Automaton fa = regex.createAutomaton(fa::RegexConstruction::Derivatives);
+    EXPECT_TRUE(fa.isDeterministic()) << expression;
+    EXPECT_TRUE(fa.isComplete()) << expression;
+    fa::Automaton minimal = fa.createMinimalMoore(fa);
+    EXPECT_LE(minimal.countStates(), fa.countStates()) << expression;
+    EXPECT_LE(fa.countStates(), minimal.countStates() + 2) << expression;
+  }
+}
+
+TEST(RegexTest, DerivativesMinimal) {
+  fa::Regex regex("(a|b)*abb");
+  fa::Automaton fa = regex.createAutomaton(fa::RegexConstruction::Derivatives);
+  EXPECT_EQ(4u, fa.countStates());
+  EXPECT_TRUE(fa.match("babb"));
+  EXPECT_FALSE(fa.match("abba"));
+}
+
+TEST(RegexTest, LongLiteral) {
+  // Une concaténation par symbole : les constructions ne récursent pas sur la chaîne
+  std::string literal;
+  for (int i = 0; i < 100000; i++) {
+    literal += "abcdefgh"[i % 8];
+  }
+  fa::Regex regex(literal);
+  ASSERT_TRUE(regex.isValid());
+  const fa::RegexConstruction constructions[] = {
+      fa::RegexConstruction::Glushkov, fa::RegexConstruction::Thompson,
+      fa::RegexConstruction::Derivatives};
+  for (fa::RegexConstruction construction : constructions) {
+    fa::Automaton fa = regex.createAutomaton(construction);
+    if (construction == fa::RegexConstruction::Thompson) {
+      fa = fa.createWithoutEpsilon(fa);
+    }
+    EXPECT_TRUE(fa.match(literal));
+    EXPECT_FALSE(fa.match(literal.substr(1)));
+  }
+}
+
+TEST(RegexTest, NullableChain) {
+  // Les dérivées parcourent la chaîne tant que ses facteurs sont optionnels
+  std::string expression;
+  for (int i = 0; i < 50; i++) {
+    expression += "a?";
+  }
+  expression += "b";
+  fa::Automaton fa = fa::Regex(expression).createAutomaton(fa::RegexConstruction::Derivatives);
+  EXPECT_TRUE(fa.match("b"));
+  EXPECT_TRUE(fa.match(std::string(50, 'a') + "b"));
+  EXPECT_FALSE(fa.match(std::string(51, 'a') + "b"));
+  EXPECT_FALSE(fa.match("ab" "b"));
+}
+
+TEST(RegexTest, Invalid) {
+  const char* expressions[] = {"(ab", "ab)", "*a", "a|*", "[]", "[b-a]", "a\\", "[ab", "[\\xff-a]"};
+  for (const char* expression : expressions) {
+    fa::Regex regex(expression);
+    EXPECT_FALSE(regex.isValid()) << expression;
+    fa::Automaton fa = regex.createAutomaton();
+    EXPECT_TRUE(fa.isValid());
+    EXPECT_TRUE(fa.isLanguageEmpty());
+  }
+}
+
+
+/**
+ * createUnion
+*/
+
+// Automate reconnaissant a+ (ou b+ selon le symbole)
+static fa::Automaton plusAutomaton(char symbol) {
+  fa::Automaton fa;
+  fa.addState(3);
+  fa.addState(7);
+  fa.setStateInitial(3);
+  fa.setStateFinal(7);
+  fa.addSymbol(symbol);
+  fa.addTransition(3,symbol,7);
+  fa.addTransition(7,symbol,7);
+  return fa;
+}
+
+TEST(AutomatonCreateUnionTest, TwoLanguages) {
+  fa::Automaton fa = fa::Automaton::createUnion(plusAutomaton('a'), plusAutomaton('b'));
+  EXPECT_EQ(4u, fa.countStates());
+  EXPECT_EQ(4u, fa.countTransitions());
+  EXPECT_EQ(2u, fa.countSymbols());
+  EXPECT_TRUE(fa.match("a"));
+  EXPECT_TRUE(fa.match("bbb"));
+  EXPECT_FALSE(fa.match("ab"));
+  EXPECT_FALSE(fa.match(""));
+}
+
+TEST(AutomatonCreateUnionTest, SameAutomaton) {
+  fa::Automaton a = plusAutomaton('a');
+  fa::Automaton fa = fa::Automaton::createUnion(a, a);
+  EXPECT_EQ(4u, fa.countStates());
+  EXPECT_TRUE(fa.match("aa"));
+  EXPECT_FALSE(fa.match(""));
+}
+
+/**
+ * createConcatenation
+*/
+
+TEST(AutomatonCreateConcatenationTest, WithoutEpsilon) {
+  fa::Automaton fa = fa::Automaton::createConcatenation(plusAutomaton('a'), plusAutomaton('b'));
+  EXPECT_FALSE(fa.hasEpsilonTransition());
+  EXPECT_TRUE(fa.match("ab"));
+  EXPECT_TRUE(fa.match("aaabb"));
+  EXPECT_FALSE(fa.match("a"));
+  EXPECT_FALSE(fa.match("b"));
+  EXPECT_FALSE(fa.match("aba"));
+}
+
+TEST(AutomatonCreateConcatenationTest, WithEpsilon) {
+  fa::Automaton fa = fa::Automaton::createConcatenation(plusAutomaton('a'), plusAutomaton('b'), true);
+  EXPECT_TRUE(fa.hasEpsilonTransition());
+  EXPECT_EQ(5u, fa.countTransitions());
+  fa = fa.createWithoutEpsilon(fa);
+  EXPECT_TRUE(fa.match("ab"));
+  EXPECT_TRUE(fa.match("aaabb"));
+  EXPECT_FALSE(fa.match("a"));
+  EXPECT_FALSE(fa.match("aba"));
+}
+
+TEST(AutomatonCreateConcatenationTest, EmptyWordOnTheRight) {
+  fa::Automaton rhs = fa::Automaton::createKleeneStar(plusAutomaton('b'));
+  fa::Automaton fa = fa::Automaton::createConcatenation(plusAutomaton('a'), rhs);
+  EXPECT_TRUE(fa.match("a"));
+  EXPECT_TRUE(fa.match("aabbb"));
+  EXPECT_FALSE(fa.match(""));
+  EXPECT_FALSE(fa.match("b"));
+}
+
+/**
+ * createKleeneStar
+*/
+
+TEST(AutomatonCreateKleeneStarTest, WithoutEpsilon) {
+  fa::Automaton ab = fa::Automaton::createConcatenation(plusAutomaton('a'), plusAutomaton('b'));
+  fa::Automaton fa = fa::Automaton::createKleeneStar(ab);
+  EXPECT_FALSE(fa.hasEpsilonTransition());
+  EXPECT_TRUE(fa.match(""));
+  EXPECT_TRUE(fa.match("ab"));
+  EXPECT_TRUE(fa.match("aabbab"));
+  EXPECT_FALSE(fa.match("aba"));
+  EXPECT_FALSE(fa.match("b"));
+}
+
+TEST(AutomatonCreateKleeneStarTest, WithEpsilon) {
+  fa::Automaton fa = fa::Automaton::createKleeneStar(plusAutomaton('a'), true);
+  EXPECT_TRUE(fa.hasEpsilonTransition());
+  EXPECT_EQ(3u, fa.countStates());
+  fa = fa.createWithoutEpsilon(fa);
+  EXPECT_TRUE(fa.match(""));
+  EXPECT_TRUE(fa.match("aaaa"));
+}
+
+TEST(AutomatonCreateKleeneStarTest, NoDuplicateTransition) {
+  // L'état initial est aussi final
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.setStateInitial(0);
+  fa.setStateFinal(0);
+  fa.addSymbol('a');
+  fa.addTransition(0,'a',0);
+  fa = fa.createKleeneStar(fa);
+  EXPECT_EQ(2u, fa.countStates());
+  EXPECT_EQ(2u, fa.countTransitions());
+  EXPECT_TRUE(fa.match("aa"));
+}
+
+
+/**
+ * compact
+*/
+
+TEST(AutomatonCompactTest, SparseStates) {
+  fa::Automaton fa;
+  fa.addState(40);
+  fa.addState(10);
+  fa.addState(25);
+  fa.addState(7);
+  fa.setStateInitial(25);
+  fa.setStateFinal(7);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addTransition(25,'b',10);
+  fa.addTransition(25,'a',40);
+  fa.addTransition(40,'a',7);
+  fa.addTransition(10,'b',7);
+  EXPECT_FALSE(fa.isCompact());
+  std::map<int, int> numbers = fa.compact();
+  EXPECT_TRUE(fa.isCompact());
+  EXPECT_EQ(0, numbers[25]);
+  EXPECT_EQ(1, numbers[40]);
+  EXPECT_EQ(2, numbers[10]);
+  EXPECT_EQ(3, numbers[7]);
+  EXPECT_EQ(4u, fa.countStates());
+  EXPECT_EQ(4u, fa.countTransitions());
+  EXPECT_TRUE(fa.isStateInitial(0));
+  EXPECT_TRUE(fa.isStateFinal(3));
+  EXPECT_TRUE(fa.hasTransition(0,'a',1));
+  EXPECT_TRUE(fa.hasTransition(0,'b',2));
+  EXPECT_TRUE(fa.match("aa"));
+  EXPECT_TRUE(fa.match("bb"));
+}
+
+TEST(AutomatonCompactTest, NonAccessibleStatesLast) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addState(5);
+  fa.setStateInitial(5);
+  fa.addSymbol('a');
+  fa.addTransition(5,'a',5);
+  std::map<int, int> numbers = fa.compact();
+  EXPECT_EQ(0, numbers[5]);
+  EXPECT_EQ(1, numbers[0]);
+  EXPECT_EQ(2, numbers[1]);
+  EXPECT_TRUE(fa.hasTransition(0,'a',0));
+}
+
+TEST(AutomatonCompactTest, AfterRemoveState) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addState(2);
+  fa.setStateInitial(0);
+  fa.setStateFinal(2);
+  fa.addSymbol('a');
+  fa.addTransition(0,'a',2);
+  EXPECT_TRUE(fa.isCompact());
+  fa.removeState(1);
+  EXPECT_FALSE(fa.isCompact());
+  fa.compact();
+  EXPECT_TRUE(fa.isCompact());
+  EXPECT_TRUE(fa.match("a"));
+}
+
+TEST(AutomatonCompactTest, MinimalIsCompact) {
+  fa::Automaton fa;
+  fa.addState(3);
+  fa.addState(8);
+  fa.setStateInitial(3);
+  fa.setStateFinal(8);
+  fa.addSymbol('a');
+  fa.addTransition(3,'a',8);
+  fa.addTransition(8,'a',8);
+  EXPECT_TRUE(fa.createMinimalMoore(fa).isCompact());
+  EXPECT_TRUE(fa.createMinimalMooreParallel(fa).isCompact());
+  EXPECT_TRUE(fa.createMinimalMoore(fa).isStateInitial(0));
+}
+
+
+/**
+ * StateTable
+*/
+TEST(StateTableTest, DenseNumbers) {
+  fa::StateTable table;
+  EXPECT_TRUE(table.empty());
+  EXPECT_TRUE(table.insert(2));
+  EXPECT_TRUE(table.insert(0));
+  EXPECT_FALSE(table.insert(2));
+  EXPECT_EQ(2u, table.size());
+  EXPECT_TRUE(table.contains(0));
+  EXPECT_FALSE(table.contains(1));
+  EXPECT_TRUE(table.contains(2));
+  EXPECT_FALSE(table.isCompact());
+  EXPECT_TRUE(table.insert(1));
+  EXPECT_TRUE(table.isCompact());
+}
+
+TEST(StateTableTest, Flags) {
+  fa::StateTable table;
+  table.insert(3);
+  table.setInitial(3);
+  table.setFinal(4);
+  EXPECT_TRUE(table.isInitial(3));
+  EXPECT_FALSE(table.isFinal(3));
+  EXPECT_FALSE(table.isFinal(4));
+  EXPECT_FALSE(table.contains(4));
+  table.setFinal(3);
+  EXPECT_TRUE(table.isFinal(3));
+  EXPECT_TRUE(table.erase(3));
+  EXPECT_FALSE(table.erase(3));
+  EXPECT_TRUE(table.insert(3));
+  EXPECT_FALSE(table.isInitial(3));
+  EXPECT_FALSE(table.isFinal(3));
+}
+
+TEST(StateTableTest, SparseNumbers) {
+  fa::StateTable table;
+  table.insert(5);
+  table.insert(1000000);
+  table.insert(0);
+  table.setFinal(1000000);
+  EXPECT_EQ(3u, table.size());
+  EXPECT_TRUE(table.contains(1000000));
+  EXPECT_TRUE(table.isFinal(1000000));
+  EXPECT_FALSE(table.contains(999999));
+  EXPECT_FALSE(table.isCompact());
+  table.erase(1000000);
+  EXPECT_FALSE(table.contains(1000000));
+  table.insert(1);
+  table.insert(2);
+  table.insert(3);
+  table.insert(4);
+  EXPECT_TRUE(table.isCompact());
+}
+
+TEST(StateTableTest, IterationOrder) {
+  fa::StateTable table;
+  table.insert(7);
+  table.insert(3);
+  table.insert(12345678);
+  table.insert(-1);
+  table.setInitial(3);
+  std::vector<int> numbers;
+  for (const auto& s : table) {
+    numbers.push_back(s.first);
+    EXPECT_EQ(s.first == 3, s.second.isInitial);
+  }
+  EXPECT_EQ(std::vector<int>({-1, 3, 7, 12345678}), numbers);
+}
+
+TEST(StateTableTest, AutomatonWithLargeNumbers) {
+  fa::Automaton fa;
+  EXPECT_TRUE(fa.addState(0));
+  EXPECT_TRUE(fa.addState(2000000000));
+  fa.setStateInitial(0);
+  fa.setStateFinal(2000000000);
+  EXPECT_TRUE(fa.addSymbol('a'));
+  EXPECT_TRUE(fa.addTransition(0, 'a', 2000000000));
+  EXPECT_TRUE(fa.match("a"));
+  EXPECT_FALSE(fa.match("aa"));
+  fa.compact();
+  EXPECT_TRUE(fa.hasState(1));
+  EXPECT_TRUE(fa.isStateFinal(1));
+  EXPECT_TRUE(fa.match("a"));
+}
+
+/**
+ * FrozenAutomaton
+*/
+TEST(FrozenAutomatonTest, Counts) {
+  fa::Automaton fa = nthLastIsA(3);
+  fa::FrozenAutomaton frozen = fa.freeze();
+  EXPECT_EQ(fa.countStates(), frozen.countStates());
+  EXPECT_EQ(fa.countTransitions(), frozen.countTransitions());
+}
+
+TEST(FrozenAutomatonTest, SparseNumbers) {
+  fa::Automaton fa;
+  fa.addState(10);
+  fa.addState(500);
+  fa.addState(7000);
+  fa.setStateInitial(10);
+  fa.setStateFinal(7000);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addTransition(10, 'b', 500);
+  fa.addTransition(10, 'a', 7000);
+  fa.addTransition(500, 'a', 7000);
+  fa.addTransition(10, 'a', 10);
+  fa::FrozenAutomaton frozen = fa.freeze();
+  EXPECT_EQ(std::set<int>({10, 7000}), frozen.readString("aa"));
+  EXPECT_EQ(std::set<int>({7000}), frozen.readString("ba"));
+  EXPECT_TRUE(frozen.readString("bb").empty());
+  EXPECT_TRUE(frozen.match("aaa"));
+  EXPECT_TRUE(frozen.match("aba"));
+  EXPECT_FALSE(frozen.match("ab"));
+  EXPECT_FALSE(frozen.match(""));
+}
+
+TEST(FrozenAutomatonTest, Properties) {
+  fa::Automaton fa = nthLastIsA(2);
+  fa::FrozenAutomaton frozen = fa.freeze();
+  EXPECT_FALSE(frozen.isDeterministic());
+  EXPECT_FALSE(frozen.isComplete());
+  EXPECT_FALSE(frozen.isLanguageEmpty());
+
+  fa::Automaton dfa = fa::Automaton::createMinimalMoore(fa);
+  fa::FrozenAutomaton frozen_dfa = dfa.freeze();
+  EXPECT_TRUE(frozen_dfa.isDeterministic());
+  EXPECT_TRUE(frozen_dfa.isComplete());
+  EXPECT_FALSE(frozen_dfa.isLanguageEmpty());
+}
+
+TEST(FrozenAutomatonTest, EpsilonIsNotDeterministic) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('a');
+  fa.addTransition(0, 'a', 0);
+  fa.addTransition(1, 'a', 1);
+  fa.addTransition(0, fa::Epsilon, 1);
+  fa::FrozenAutomaton frozen = fa.freeze();
+  EXPECT_FALSE(frozen.isDeterministic());
+  EXPECT_TRUE(frozen.isComplete());
+  EXPECT_FALSE(frozen.isLanguageEmpty());
+  EXPECT_FALSE(frozen.match("a"));
+}
+
+TEST(FrozenAutomatonTest, EmptyLanguage) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('a');
+  fa.addTransition(1, 'a', 0);
+  EXPECT_TRUE(fa.freeze().isLanguageEmpty());
+  fa.addTransition(0, 'a', 1);
+  EXPECT_FALSE(fa.freeze().isLanguageEmpty());
+}
+
+TEST(FrozenAutomatonTest, IndependentOfLaterChanges) {
+  fa::Automaton fa = wordAutomaton("ab");
+  fa::FrozenAutomaton frozen = fa.freeze();
+  fa.removeState(0);
+  EXPECT_TRUE(frozen.match("ab"));
+  EXPECT_FALSE(fa.match("ab"));
+}
+
+/**
+ * Cached properties
+*/
+TEST(AutomatonPropertiesTest, GenerationIncremented) {
+  fa::Automaton fa;
+  std::size_t generation = fa.getGeneration();
+  fa.addState(0);
+  EXPECT_LT(generation, fa.getGeneration());
+  generation = fa.getGeneration();
+  fa.addSymbol('a');
+  EXPECT_LT(generation, fa.getGeneration());
+  generation = fa.getGeneration();
+  EXPECT_FALSE(fa.isComplete());
+  EXPECT_FALSE(fa.isDeterministic());
+  EXPECT_EQ(generation, fa.getGeneration());
+}
+
+TEST(AutomatonPropertiesTest, UpdatedAfterChanges) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addSymbol('a');
+  fa.setStateInitial(0);
+  EXPECT_TRUE(fa.isDeterministic());
+  EXPECT_FALSE(fa.isComplete());
+  EXPECT_TRUE(fa.isLanguageEmpty());
+  EXPECT_EQ(0u, fa.countFinalStates());
+
+  fa.setStateFinal(1);
+  fa.addTransition(0, 'a', 1);
+  fa.addTransition(1, 'a', 1);
+  EXPECT_TRUE(fa.isComplete());
+  EXPECT_FALSE(fa.isLanguageEmpty());
+  EXPECT_EQ(1u, fa.countFinalStates());
+
+  fa.addTransition(0, 'a', 0);
+  EXPECT_FALSE(fa.isDeterministic());
+  fa.removeTransition(0, 'a', 0);
+  EXPECT_TRUE(fa.isDeterministic());
+
+  EXPECT_FALSE(fa.hasEpsilonTransition());
+  fa.addTransition(1, fa::Epsilon, 0);
+  EXPECT_TRUE(fa.hasEpsilonTransition());
+}
+
+TEST(AutomatonPropertiesTest, InitialStates) {
+  fa::Automaton fa;
+  fa.addState(4);
+  fa.addState(2);
+  fa.addState(9);
+  fa.addSymbol('a');
+  EXPECT_TRUE(fa.getInitialStates().empty());
+  fa.setStateInitial(9);
+  fa.setStateInitial(2);
+  EXPECT_EQ(std::vector<int>({2, 9}), fa.getInitialStates());
+  fa.removeState(2);
+  EXPECT_EQ(std::vector<int>({9}), fa.getInitialStates());
+}
+
+TEST(AutomatonPropertiesTest, Trimmed) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addState(2);
+  fa.addSymbol('a');
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addTransition(0, 'a', 1);
+  fa.addTransition(0, 'a', 2);
+  EXPECT_FALSE(fa.isTrimmed());
+  fa.removeNonCoAccessibleStates();
+  EXPECT_TRUE(fa.isTrimmed());
+  EXPECT_EQ(2u, fa.countStates());
+
+  std::size_t generation = fa.getGeneration();
+  fa.removeNonAccessibleStates();
+  EXPECT_EQ(generation, fa.getGeneration());
+}
+
+TEST(AutomatonPropertiesTest, DirectChangesOfMembers) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addSymbol('a');
+  fa.setStateInitial(0);
+  EXPECT_FALSE(fa.isComplete());
+  // Les modifications directes sont suivies d'un appel à invalidate
+  fa.set_of_transitions.push_back({0, 'a', 0});
+  std::size_t generation = fa.getGeneration();
+  fa.invalidate();
+  EXPECT_NE(generation, fa.getGeneration());
+  EXPECT_TRUE(fa.isComplete());
+}
+
+TEST(AutomatonPropertiesTest, DirectChangesOfSameSize) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.setStateInitial(0);
+  fa.addTransition(0, 'a', 1);
+  EXPECT_TRUE(fa.isLanguageEmpty());
+
+  // Les tailles ne changent pas
+  fa.set_of_states.setFinal(1);
+  fa.invalidate();
+  EXPECT_FALSE(fa.isLanguageEmpty());
+  EXPECT_EQ(1u, fa.countFinalStates());
+  EXPECT_TRUE(fa.match("a"));
+
+  fa.set_of_transitions[0].symbol = 'b';
+  fa.invalidate();
+  EXPECT_FALSE(fa.match("a"));
+  EXPECT_TRUE(fa.match("b"));
+  fa.set_of_transitions[0].to = 0;
+  fa.invalidate();
+  EXPECT_TRUE(fa.isLanguageEmpty());
+}
+
+TEST(AutomatonPropertiesTest, ConcurrentQueries) {
+  const fa::Automaton fa = nthLastIsA(6);
+  std::atomic<int> errors(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 200; j++) {
+        if (fa.isDeterministic() || fa.isLanguageEmpty() ||
+            fa.getInitialStates().size() != 1 || fa.countFinalStates() != 1) {
+          errors++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, errors.load());
+}
+
+TEST(AutomatonPropertiesTest, MatcherUpdatedAfterChanges) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addSymbol('a');
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addTransition(0, 'a', 1);
+  EXPECT_TRUE(fa.match("a"));
+  EXPECT_FALSE(fa.match("aa"));
+  fa.addTransition(1, 'a', 1);
+  EXPECT_TRUE(fa.match("aa"));
+  EXPECT_EQ(std::set<int>({1}), fa.readString("aaa"));
+  fa.set_of_states.setFinal(0);
+  fa.invalidate();
+  EXPECT_TRUE(fa.match(""));
+}
+
+TEST(AutomatonPropertiesTest, ConcurrentMatches) {
+  // Un automate de chaque taille : bit-parallèle et figé
+  const fa::Automaton small = nthLastIsA(6);
+  const fa::Automaton large = fa::Automaton::createDeterministic(nthLastIsA(7));
+  ASSERT_LT(fa::BitParallelAutomaton::MaxStates, large.countStates());
+  std::atomic<int> errors(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 200; j++) {
+        if (!small.match("abbbbb") || small.match("abbbbbb") ||
+            !large.match("abbbbbb") || large.match("abbbbbbb")) {
+          errors++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, errors.load());
+}
+
+TEST(AutomatonPropertiesTest, CopyKeepsProperties) {
+  fa::Automaton fa = nthLastIsA(3);
+  EXPECT_FALSE(fa.isDeterministic());
+  fa::Automaton copy = fa;
+  EXPECT_FALSE(copy.isDeterministic());
+  fa::Automaton dfa = fa::Automaton::createDeterministic(copy);
+  EXPECT_TRUE(dfa.isDeterministic());
+  EXPECT_FALSE(copy.isDeterministic());
+}
+
+/**
+ * findNonDeterminism / findMissingTransition
+*/
+TEST(AutomatonFindNonDeterminismTest, Deterministic) {
+  fa::Automaton fa = fa::Automaton::createMinimalMoore(nthLastIsA(2));
+  fa::PropertyViolation violation = fa.findNonDeterminism();
+  EXPECT_FALSE(violation.found);
+}
+
+TEST(AutomatonFindNonDeterminismTest, InitialStates) {
+  fa::Automaton fa;
+  fa.addState(3);
+  fa.addState(1);
+  fa.addState(8);
+  fa.addSymbol('a');
+  fa::PropertyViolation violation = fa.findNonDeterminism();
+  EXPECT_TRUE(violation.found);
+  EXPECT_EQ(-1, violation.state);
+
+  fa.setStateInitial(8);
+  fa.setStateInitial(3);
+  violation = fa.findNonDeterminism();
+  EXPECT_TRUE(violation.found);
+  EXPECT_EQ(8, violation.state);
+}
+
+TEST(AutomatonFindNonDeterminismTest, Transitions) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addState(2);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.setStateInitial(0);
+  fa.addTransition(2, 'b', 0);
+  fa.addTransition(2, 'b', 1);
+  fa.addTransition(0, 'a', 1);
+  fa.addTransition(1, 'a', 2);
+  fa.addTransition(1, fa::Epsilon, 0);
+  fa::PropertyViolation violation = fa.findNonDeterminism();
+  EXPECT_TRUE(violation.found);
+  EXPECT_EQ(1, violation.state);
+  EXPECT_EQ(fa::Epsilon, violation.symbol);
+
+  fa.removeTransition(1, fa::Epsilon, 0);
+  violation = fa.findNonDeterminism();
+  EXPECT_TRUE(violation.found);
+  EXPECT_EQ(2, violation.state);
+  EXPECT_EQ('b', violation.symbol);
+}
+
+TEST(AutomatonFindMissingTransitionTest, Complete) {
+  fa::Automaton fa = fa::Automaton::createComplete(nthLastIsA(2));
+  EXPECT_FALSE(fa.findMissingTransition().found);
+}
+
+TEST(AutomatonFindMissingTransitionTest, FirstMissing) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addSymbol('c');
+  fa.setStateInitial(0);
+  fa.addTransition(0, 'a', 0);
+  fa.addTransition(0, 'b', 0);
+  fa.addTransition(0, 'c', 1);
+  fa.addTransition(1, 'a', 1);
+  fa.addTransition(1, 'c', 1);
+  fa::PropertyViolation violation = fa.findMissingTransition();
+  EXPECT_TRUE(violation.found);
+  EXPECT_EQ(1, violation.state);
+  EXPECT_EQ('b', violation.symbol);
+}
+
+TEST(AutomatonFindMissingTransitionTest, LargeAutomaton) {
+  // Un cycle de 200000 états sur deux symboles
+  const int nb_states = 200000;
+  fa::Automaton fa;
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  for (int s = 0; s < nb_states; s++) {
+    fa.addState(s);
+  }
+  fa.setStateInitial(0);
+  fa.setStateFinal(nb_states - 1);
+  for (int s = 0; s < nb_states; s++) {
+    fa.set_of_transitions.push_back({s, 'a', (s + 1) % nb_states});
+    fa.set_of_transitions.push_back({s, 'b', 0});
+  }
+  EXPECT_TRUE(fa.isDeterministic());
+  EXPECT_TRUE(fa.isComplete());
+  fa.set_of_transitions.pop_back();
+  fa.invalidate();
+  fa::PropertyViolation violation = fa.findMissingTransition();
+  EXPECT_TRUE(violation.found);
+  EXPECT_EQ(nb_states - 1, violation.state);
+  EXPECT_EQ('b', violation.symbol);
+}
+
+/**
+ * Memory resource
+*/
+// Ressource mémoire qui compte les allocations en cours
+class CountingResource : public std::pmr::memory_resource {
+public:
+  std::size_t nb_allocations = 0;
+  std::size_t nb_live_allocations = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    nb_allocations++;
+    nb_live_allocations++;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    nb_live_allocations--;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const
+      noexcept override {
+    return this == &other;
+  }
+};
+
+TEST(AutomatonResourceTest, DefaultResource) {
+  fa::Automaton fa;
+  EXPECT_EQ(std::pmr::get_default_resource(), fa.getResource());
+}
+
+TEST(AutomatonResourceTest, GivenResource) {
+  CountingResource resource;
+  {
+    fa::Automaton fa(&resource);
+    EXPECT_EQ(&resource, fa.getResource());
+    fa.addState(0);
+    fa.addState(1000000);
+    fa.addSymbol('a');
+    fa.addTransition(0, 'a', 1000000);
+    EXPECT_LT(0u, resource.nb_allocations);
+
+    fa::Automaton copy = fa;
+    EXPECT_EQ(std::pmr::get_default_resource(), copy.getResource());
+
+    fa::Automaton assigned(&resource);
+    assigned = copy;
+    EXPECT_EQ(&resource, assigned.getResource());
+    EXPECT_TRUE(assigned.hasTransition(0, 'a', 1000000));
+  }
+  EXPECT_EQ(0u, resource.nb_live_allocations);
+}
+
+TEST(AutomatonResourceTest, StaticMethodsUseResourceOfArgument) {
+  CountingResource resource;
+  fa::Automaton fa(&resource);
+  fa = nthLastIsA(3);
+  EXPECT_EQ(&resource, fa::Automaton::createMirror(fa).getResource());
+  EXPECT_EQ(&resource, fa::Automaton::createComplete(fa).getResource());
+  EXPECT_EQ(&resource, fa::Automaton::createDeterministic(fa).getResource());
+  EXPECT_EQ(&resource, fa::Automaton::createMinimalMoore(fa).getResource());
+  EXPECT_EQ(&resource, fa::Automaton::createProduct(fa, nthLastIsA(2)).getResource());
+  EXPECT_EQ(&resource, fa::Automaton::createKleeneStar(fa).getResource());
+
+  // Automate déjà déterministe : copie dans la même ressource
+  fa::Automaton dfa = fa::Automaton::createDeterministic(fa);
+  EXPECT_EQ(&resource, fa::Automaton::createDeterministic(dfa).getResource());
+}
+
+TEST(AutomatonResourceTest, PipelineInArena) {
+  std::pmr::monotonic_buffer_resource arena;
+  fa::Automaton fa(&arena);
+  fa = nthLastIsA(4);
+  fa::Automaton minimal = fa::Automaton::createMinimalBrzozowski(fa);
+  fa::Automaton complement = fa::Automaton::createComplement(minimal);
+  EXPECT_EQ(&arena, minimal.getResource());
+  EXPECT_EQ(&arena, complement.getResource());
+  EXPECT_EQ(16u, minimal.countStates());
+  EXPECT_TRUE(minimal.match("abbb"));
+  EXPECT_FALSE(complement.match("abbb"));
+  EXPECT_TRUE(complement.match("babb"));
+}
+
+TEST(AutomatonResourceTest, IntermediatesReleased) {
+  CountingResource resource;
+  {
+    fa::Automaton fa(&resource);
+    fa = nthLastIsA(3);
+    std::size_t nb_allocations = resource.nb_allocations;
+    fa::Automaton minimal = fa::Automaton::createMinimalBrzozowski(fa);
+    EXPECT_EQ(&resource, minimal.getResource());
+    // Seul le résultat est alloué dans la ressource de l'argument
+    fa::Automaton copy(&resource);
+    std::size_t nb_allocations_result = resource.nb_allocations;
+    copy = minimal;
+    EXPECT_EQ(nb_allocations_result - nb_allocations,
+              resource.nb_allocations - nb_allocations_result);
+  }
+  EXPECT_EQ(0u, resource.nb_live_allocations);
+}
+
+/**
+ * setStatsCallback
+*/
+// Statistiques reçues, par nom d'opération
+static std::map<std::string, std::vector<fa::OperationStats>> received_stats;
+
+static void receiveStats(const std::string& operation,
+                         const fa::OperationStats& stats) {
+  received_stats[operation].push_back(stats);
+}
+
+#ifdef FA_STATS
+TEST(AutomatonStatsTest, Deterministic) {
+  received_stats.clear();
+  fa::Automaton::setStatsCallback(receiveStats);
+  fa::Automaton dfa = fa::Automaton::createDeterministic(nthLastIsA(3));
+  fa::Automaton::setStatsCallback(nullptr);
+
+  ASSERT_EQ(1u, received_stats["createDeterministic"].size());
+  const fa::OperationStats& stats = received_stats["createDeterministic"][0];
+  EXPECT_EQ(dfa.countStates(), stats.states_created);
+  EXPECT_EQ(dfa.countTransitions(), stats.transitions_created);
+  EXPECT_EQ(8u, stats.macrostates_explored);
+  EXPECT_LT(0u, stats.bytes_allocated);
+  EXPECT_LE(0.0, stats.seconds);
+}
+
+TEST(AutomatonStatsTest, NestedOperations) {
+  received_stats.clear();
+  fa::Automaton::setStatsCallback(receiveStats);
+  fa::Automaton minimal = fa::Automaton::createMinimalMoore(nthLastIsA(3));
+  fa::Automaton::setStatsCallback(nullptr);
+
+  ASSERT_EQ(1u, received_stats["createDeterministic"].size());
+  ASSERT_EQ(1u, received_stats["createComplete"].size());
+  ASSERT_EQ(1u, received_stats["createMinimalMoore"].size());
+  const fa::OperationStats& stats = received_stats["createMinimalMoore"][0];
+  EXPECT_EQ(8u, stats.macrostates_explored);
+  EXPECT_LT(0u, stats.refinement_rounds);
+  EXPECT_EQ(received_stats["createDeterministic"][0].states_created +
+                minimal.countStates(),
+            stats.states_created);
+}
+
+TEST(AutomatonStatsTest, MooreParallelRounds) {
+  received_stats.clear();
+  fa::Automaton::setStatsCallback(receiveStats);
+  fa::Automaton::createMinimalMooreParallel(nthLastIsA(4), 2);
+  fa::Automaton::setStatsCallback(nullptr);
+
+  ASSERT_EQ(1u, received_stats["createMinimalMooreParallel"].size());
+  EXPECT_LT(0u, received_stats["createMinimalMooreParallel"][0].refinement_rounds);
+}
+
+TEST(AutomatonStatsTest, StructuralBuilders) {
+  received_stats.clear();
+  fa::Automaton::setStatsCallback(receiveStats);
+  fa::Automaton a = nthLastIsA(2);
+  fa::Automaton star = fa::Automaton::createKleeneStar(a, true);
+  fa::Automaton without = fa::Automaton::createWithoutEpsilon(star);
+  fa::Automaton uni = fa::Automaton::createUnion(a, without);
+  fa::Automaton concatenation = fa::Automaton::createConcatenation(a, uni);
+  fa::Automaton keywords = fa::Automaton::createAhoCorasick({"ab", "ba"});
+  fa::Automaton::setStatsCallback(nullptr);
+
+  ASSERT_EQ(1u, received_stats["createKleeneStar"].size());
+  ASSERT_EQ(1u, received_stats["createWithoutEpsilon"].size());
+  ASSERT_EQ(1u, received_stats["createUnion"].size());
+  ASSERT_EQ(1u, received_stats["createConcatenation"].size());
+  ASSERT_EQ(1u, received_stats["createAhoCorasick"].size());
+  EXPECT_EQ(star.countStates(),
+            received_stats["createKleeneStar"][0].states_created);
+  EXPECT_EQ(without.countTransitions(),
+            received_stats["createWithoutEpsilon"][0].transitions_created);
+  EXPECT_EQ(uni.countStates(), received_stats["createUnion"][0].states_created);
+  EXPECT_EQ(concatenation.countTransitions(),
+            received_stats["createConcatenation"][0].transitions_created);
+  EXPECT_EQ(keywords.countStates(),
+            received_stats["createAhoCorasick"][0].states_created);
+}
+#else
+TEST(AutomatonStatsTest, NotCollected) {
+  received_stats.clear();
+  fa::Automaton::setStatsCallback(receiveStats);
+  fa::Automaton::createMinimalMoore(nthLastIsA(3));
+  fa::Automaton::setStatsCallback(nullptr);
+  EXPECT_TRUE(received_stats.empty());
+}
+#endif
+
+/**
+ * ConstructionOptions
+*/
+TEST(AutomatonConstructionOptionsTest, DeterministicCompleted) {
+  fa::ConstructionOptions options;
+  options.max_states = 1024;
+  fa::ConstructionResult result =
+      fa::Automaton::createDeterministic(nthLastIsA(10), options);
+  EXPECT_EQ(fa::ConstructionStatus::Completed, result.status);
+  EXPECT_EQ(1024u, result.automaton.countStates());
+  EXPECT_TRUE(result.automaton.isDeterministic());
+}
+
+TEST(AutomatonConstructionOptionsTest, DeterministicBudgetExceeded) {
+  fa::ConstructionOptions options;
+  options.max_states = 1023;
+  fa::ConstructionResult result =
+      fa::Automaton::createDeterministic(nthLastIsA(10), options);
+  EXPECT_EQ(fa::ConstructionStatus::BudgetExceeded, result.status);
+  EXPECT_EQ(0u, result.automaton.countStates());
+
+  // Automate déjà déterministe
+  fa::Automaton dfa = fa::Automaton::createDeterministic(nthLastIsA(2));
+  options.max_states = 3;
+  EXPECT_EQ(fa::ConstructionStatus::BudgetExceeded,
+            fa::Automaton::createDeterministic(dfa, options).status);
+}
+
+TEST(AutomatonConstructionOptionsTest, DeterministicCancelled) {
+  std::atomic<bool> cancel(true);
+  fa::ConstructionOptions options;
+  options.cancel = &cancel;
+  fa::ConstructionResult result =
+      fa::Automaton::createDeterministic(nthLastIsA(10), options);
+  EXPECT_EQ(fa::ConstructionStatus::Cancelled, result.status);
+}
+
+TEST(AutomatonConstructionOptionsTest, CancelledFromProgress) {
+  std::atomic<bool> cancel(false);
+  std::vector<std::size_t> progress;
+  fa::ConstructionOptions options;
+  options.cancel = &cancel;
+  options.progress_interval = 100;
+  options.progress = [&](std::size_t nb_states) {
+    progress.push_back(nb_states);
+    if (nb_states == 300) {
+      cancel = true;
+    }
+  };
+  fa::ConstructionResult result =
+      fa::Automaton::createDeterministic(nthLastIsA(10), options);
+  EXPECT_EQ(fa::ConstructionStatus::Cancelled, result.status);
+  EXPECT_EQ(std::vector<std::size_t>({100, 200, 300}), progress);
+}
+
+TEST(AutomatonConstructionOptionsTest, Product) {
+  fa::ConstructionOptions options;
+  fa::ConstructionResult result = fa::Automaton::createProduct(
+      wordAutomaton("ab"), wordAutomaton("ab"), options);
+  EXPECT_EQ(fa::ConstructionStatus::Completed, result.status);
+  // Seuls les couples accessibles sont construits
+  EXPECT_EQ(3u, result.automaton.countStates());
+  EXPECT_TRUE(result.automaton.match("ab"));
+  EXPECT_FALSE(result.automaton.match("a"));
+
+  options.max_states = 2;
+  result = fa::Automaton::createProduct(wordAutomaton("ab"),
+                                        wordAutomaton("ab"), options);
+  EXPECT_EQ(fa::ConstructionStatus::BudgetExceeded, result.status);
+}
+
+TEST(AutomatonConstructionOptionsTest, MinimalBrzozowski) {
+  fa::ConstructionOptions options;
+  options.max_states = 100;
+  fa::ConstructionResult result =
+      fa::Automaton::createMinimalBrzozowski(nthLastIsA(4), options);
+  EXPECT_EQ(fa::ConstructionStatus::Completed, result.status);
+  EXPECT_EQ(16u, result.automaton.countStates());
+
+  options.max_states = 15;
+  result = fa::Automaton::createMinimalBrzozowski(nthLastIsA(4), options);
+  EXPECT_EQ(fa::ConstructionStatus::BudgetExceeded, result.status);
+}
+
+/**
+ * StaticAutomaton
+*/
+// Identifiants : une lettre puis des lettres ou des chiffres
+static constexpr fa::StaticAutomaton<2> identifier(0, {1}, {
+  {0, 'a', 1}, {0, 'b', 1}, {0, 'c', 1},
+  {1, 'a', 1}, {1, 'b', 1}, {1, 'c', 1}, {1, '0', 1}, {1, '1', 1}
+});
+
+static_assert(identifier.isValid(), "identifier must be valid");
+static_assert(identifier.match("a"), "a is an identifier");
+static_assert(identifier.match("cab10"), "cab10 is an identifier");
+static_assert(!identifier.match("1a"), "1a is not an identifier");
+static_assert(!identifier.match(""), "the empty word is not an identifier");
+static_assert(sizeof(fa::StaticAutomaton<2>::StateType) == 1, "small states");
+
+TEST(StaticAutomatonTest, Match) {
+  EXPECT_TRUE(identifier.match("abc"));
+  EXPECT_TRUE(identifier.match("b01"));
+  EXPECT_FALSE(identifier.match("0"));
+  EXPECT_FALSE(identifier.match("ab-"));
+  EXPECT_EQ(1, identifier.next(0, 'a'));
+  EXPECT_EQ(fa::StaticAutomaton<2>::Dead, identifier.next(0, '0'));
+}
+
+TEST(StaticAutomatonTest, NotValid) {
+  constexpr fa::StaticAutomaton<2> out_of_range(0, {2}, {{0, 'a', 1}});
+  constexpr fa::StaticAutomaton<2> epsilon(0, {1}, {{0, fa::Epsilon, 1}});
+  constexpr fa::StaticAutomaton<2> not_deterministic(0, {1},
+                                                    {{0, 'a', 0}, {0, 'a', 1}});
+  constexpr fa::StaticAutomaton<2> initial(3, {1}, {{0, 'a', 1}});
+  constexpr fa::StaticAutomaton<2> duplicate(0, {1}, {{0, 'a', 1}, {0, 'a', 1}});
+  EXPECT_FALSE(out_of_range.isValid());
+  EXPECT_FALSE(epsilon.isValid());
+  EXPECT_FALSE(not_deterministic.isValid());
+  EXPECT_FALSE(initial.isValid());
+  EXPECT_TRUE(duplicate.isValid());
+}
+
+TEST(StaticAutomatonTest, ToAutomaton) {
+  fa::Automaton fa = identifier.toAutomaton();
+  EXPECT_TRUE(fa.isValid());
+  EXPECT_TRUE(fa.isDeterministic());
+  EXPECT_EQ(2u, fa.countStates());
+  EXPECT_EQ(5u, fa.countSymbols());
+  EXPECT_EQ(8u, fa.countTransitions());
+  for (const std::string word : {"a", "ab0", "1", "", "a1b", "0a"}) {
+    EXPECT_EQ(identifier.match(word), fa.match(word));
+  }
+}
+
+TEST(StaticAutomatonTest, LargeStates) {
+  EXPECT_EQ(2u, sizeof(fa::StaticAutomaton<200>::StateType));
+  static constexpr fa::StaticAutomaton<200> counter(0, {199}, {
+    {0, 'x', 1}, {1, 'x', 199}
+  });
+  static_assert(counter.match("xx"), "xx reaches the final state");
+  EXPECT_FALSE(counter.match("x"));
+}
+
+/**
+ * cppPrint
+*/
+TEST(AutomatonCppPrintTest, SwitchStyle) {
+  std::ostringstream os;
+  wordAutomaton("ab").cppPrint(os, "matchAb");
+  std::string code = os.str();
+  EXPECT_NE(std::string::npos,
+            code.find("inline bool matchAb(const char* text, std::size_t length)"));
+  EXPECT_NE(std::string::npos, code.find("switch (state)"));
+  EXPECT_NE(std::string::npos, code.find("case 'a':"));
+  EXPECT_EQ(std::string::npos, code.find("goto"));
+}
+
+TEST(AutomatonCppPrintTest, GotoStyle) {
+  std::ostringstream os;
+  wordAutomaton("ab").cppPrint(os, "matchAb", fa::CodeStyle::Goto);
+  std::string code = os.str();
+  EXPECT_NE(std::string::npos, code.find("goto state_"));
+  EXPECT_NE(std::string::npos, code.find("case 'b':"));
+  EXPECT_EQ(std::string::npos, code.find("switch (state)"));
+}
+
+TEST(AutomatonCppPrintTest, EscapedSymbols) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('\'');
+  fa.addSymbol('\\');
+  fa.addTransition(0, '\'', 1);
+  fa.addTransition(1, '\\', 1);
+  std::ostringstream os;
+  fa.cppPrint(os, "matchQuote");
+  std::string code = os.str();
+  EXPECT_NE(std::string::npos, code.find("case '\\'':"));
+  EXPECT_NE(std::string::npos, code.find("case '\\\\':"));
+}
+
+TEST(AutomatonCppPrintTest, EmptyLanguage) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.setStateInitial(0);
+  fa.addSymbol('a');
+  std::ostringstream os;
+  fa.cppPrint(os, "matchNothing", fa::CodeStyle::Goto);
+  EXPECT_NE(std::string::npos, os.str().find("return false;"));
+  EXPECT_EQ(std::string::npos, os.str().find("goto"));
+}
+
+TEST(AutomatonCppPrintTest, NonAccessibleStates) {
+  // Déterministe et complet, l'état 2 n'est pas accessible
+  fa::Automaton fa;
+  for (int state = 0; state < 3; state++) {
+    fa.addState(state);
+  }
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.setStateFinal(2);
+  fa.addSymbol('a');
+  fa.addTransition(0, 'a', 1);
+  fa.addTransition(1, 'a', 1);
+  fa.addTransition(2, 'a', 0);
+  std::ostringstream os;
+  fa.cppPrint(os, "matchSomeA", fa::CodeStyle::Goto);
+  std::string code = os.str();
+  EXPECT_NE(std::string::npos, code.find("minimal automaton with 2 states"));
+  EXPECT_NE(std::string::npos, code.find("state_1:"));
+  EXPECT_EQ(std::string::npos, code.find("state_2"));
+}
+
+TEST(AutomatonCppPrintTest, GeneratedAtBuildTime) {
+  fa::Automaton fa =
+      fa::Regex("[a-z_][a-z0-9_]*").createAutomaton(fa::RegexConstruction::Derivatives);
+  for (const std::string word :
+       {"", "a", "_", "abc", "x1", "a_b_9", "1a", "a-b", "A", "a b", "zz9_"}) {
+    EXPECT_EQ(fa.match(word), matchIdentifierSwitch(word.data(), word.size()));
+    EXPECT_EQ(fa.match(word), matchIdentifierGoto(word.data(), word.size()));
+  }
+}
+
+/**
+ * prettyPrint / dotPrint
+*/
+TEST(AutomatonPrintTest, PrettyPrintOrder) {
+  fa::Automaton fa;
+  fa.addState(1);
+  fa.addState(0);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('b');
+  fa.addSymbol('a');
+  fa.addTransition(0, 'b', 1);
+  fa.addTransition(0, 'a', 1);
+  fa.addTransition(0, 'a', 0);
+  std::ostringstream os;
+  fa.prettyPrint(os);
+  EXPECT_EQ("Initial states:\n\t0 \nFinal states:\n\t1 \nTransitions:"
+            "\n\tFor state 0 :\n\t\tFor letter a : 1 0 \n\t\tFor letter b : 1 "
+            "\n\tFor state 1 :\n\t\tFor letter a : \n\t\tFor letter b : \n",
+            os.str());
+}
+
+TEST(AutomatonPrintTest, DotPrint) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  fa.addTransition(0, 'b', 1);
+  fa.addTransition(0, 'a', 1);
+  fa.addTransition(1, 'a', 1);
+  std::ostringstream os;
+  fa.dotPrint(os);
+  EXPECT_EQ("digraph automaton {\n"
+            "  rankdir = LR;\n"
+            "  node [shape = circle];\n"
+            "  0;\n"
+            "  initial_0 [shape = point, label = \"\"];\n"
+            "  initial_0 -> 0;\n"
+            "  1 [shape = doublecircle];\n"
+            "  0 -> 1 [label = \"a,b\"];\n"
+            "  1 -> 1 [label = \"a\"];\n"
+            "}\n",
+            os.str());
+}
+
+TEST(AutomatonPrintTest, DotPrintRanges) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.setStateInitial(0);
+  for (char symbol : std::string("abcdxy\"")) {
+    fa.addSymbol(symbol);
+    fa.addTransition(0, symbol, 0);
+  }
+  fa.addTransition(0, fa::Epsilon, 0);
+
+  std::ostringstream without_ranges;
+  fa.dotPrint(without_ranges);
+  EXPECT_NE(std::string::npos,
+            without_ranges.str().find("[label = \"&epsilon;,\\\",a,b,c,d,x,y\"]"));
+
+  std::ostringstream with_ranges;
+  fa.dotPrint(with_ranges, true);
+  EXPECT_NE(std::string::npos,
+            with_ranges.str().find("[label = \"&epsilon;,\\\",a-d,x,y\"]"));
+}
+
+TEST(AutomatonPrintTest, DotPrintEscapedBytes) {
+  fa::Automaton fa;
+  fa.addState(0);
+  fa.setStateInitial(0);
+  for (char symbol : std::string("\x01\x02\x03, -\xfe\xff")) {
+    fa.addSymbol(symbol);
+    fa.addTransition(0, symbol, 0);
+  }
+
+  std::ostringstream without_ranges;
+  fa.dotPrint(without_ranges);
+  EXPECT_NE(std::string::npos,
+            without_ranges.str().find("[label = \"\\\\x01,\\\\x02,\\\\x03,\\\\x20,"
+                                      "\\\\x2c,\\\\x2d,\\\\xfe,\\\\xff\"]"));
+
+  std::ostringstream with_ranges;
+  fa.dotPrint(with_ranges, true);
+  EXPECT_NE(std::string::npos,
+            with_ranges.str().find("[label = \"\\\\x01-\\\\x03,\\\\x20,\\\\x2c,"
+                                   "\\\\x2d,\\\\xfe,\\\\xff\"]"));
+}
+
+TEST(AutomatonPrintTest, LargeAutomaton) {
+  const int nb_states = 100000;
+  fa::Automaton fa;
+  fa.addSymbol('a');
+  fa.addSymbol('b');
+  for (int s = 0; s < nb_states; s++) {
+    fa.addState(s);
+  }
+  fa.setStateInitial(0);
+  for (int s = 0; s < nb_states; s++) {
+    fa.set_of_transitions.push_back({s, 'a', (s + 1) % nb_states});
+    fa.set_of_transitions.push_back({s, 'b', (s + 1) % nb_states});
+  }
+  std::ostringstream dot;
+  fa.dotPrint(dot);
+  EXPECT_NE(std::string::npos, dot.str().find("  99999 -> 0 [label = \"a,b\"];\n"));
+  std::ostringstream pretty;
+  fa.prettyPrint(pretty);
+  EXPECT_NE(std::string::npos,
+            pretty.str().find("For state 99999 :\n\t\tFor letter a : 0 \n"));
+}
+
+/**
+ * Parser
+*/
+TEST(ParserTest, SimpleFormat) {
+  fa::ParseResult result = fa::Parser::parse("# a puis b\n"
+                                             "initial 0\n"
+                                             "final 2\n"
+                                             "\n"
+                                             "0 a 1\r\n"
+                                             "1\tb 2\n"
+                                             "1 b 2\n"
+                                             "2 eps 0",
+                                             fa::TextFormat::Simple);
+  ASSERT_TRUE(result.valid);
+  EXPECT_EQ(0u, result.line);
+  const fa::Automaton& fa = result.automaton;
+  EXPECT_TRUE(fa.isValid());
+  EXPECT_EQ(3u, fa.countStates());
+  EXPECT_EQ(3u, fa.countTransitions());
+  EXPECT_EQ(2u, fa.countSymbols());
+  EXPECT_TRUE(fa.isStateInitial(0));
+  EXPECT_TRUE(fa.isStateFinal(2));
+  EXPECT_TRUE(fa.hasTransition(2, fa::Epsilon, 0));
+  EXPECT_TRUE(fa.match("ab"));
+  EXPECT_FALSE(fa.match("a"));
+}
+
+TEST(ParserTest, SimpleFormatError) {
+  fa::ParseResult result = fa::Parser::parse("initial 0\n0 a 1\n0 ab 1\n",
+                                             fa::TextFormat::Simple);
+  EXPECT_FALSE(result.valid);
+  EXPECT_EQ(3u, result.line);
+  EXPECT_FALSE(fa::Parser::parse("initial -1\n", fa::TextFormat::Simple).valid);
+  EXPECT_FALSE(fa::Parser::parse("0 a 1 2\n", fa::TextFormat::Simple).valid);
+  EXPECT_FALSE(fa::Parser::parse("alphabet eps\n", fa::TextFormat::Simple).valid);
+}
+
+TEST(ParserTest, LargeStateNumbers) {
+  std::string text = "initial 1000000\nfinal 2000000\n";
+  for (int i = 0; i < 100; i++) {
+    text += "1000000 a 2000000\n2000000 b 1000000\n";
+  }
+  fa::ParseResult result = fa::Parser::parse(text, fa::TextFormat::Simple);
+  ASSERT_TRUE(result.valid);
+  EXPECT_EQ(2u, result.automaton.countStates());
+  EXPECT_EQ(2u, result.automaton.countTransitions());
+  EXPECT_TRUE(result.automaton.match("aba"));
+}
+
+TEST(ParserTest, BAFormat) {
+  fa::ParseResult result = fa::Parser::parse("[init]\n"
+                                             "a,[init]->[middle]\n"
+                                             "b , [middle] -> [end]\n"
+                                             "a,[end]->[end]\n"
+                                             "[end]\n",
+                                             fa::TextFormat::BA);
+  ASSERT_TRUE(result.valid);
+  const fa::Automaton& fa = result.automaton;
+  EXPECT_EQ(3u, fa.countStates());
+  EXPECT_EQ(3u, fa.countTransitions());
+  EXPECT_TRUE(fa.isStateInitial(0));
+  EXPECT_TRUE(fa.isStateFinal(2));
+  EXPECT_FALSE(fa.isStateFinal(1));
+  EXPECT_TRUE(fa.match("ab"));
+  EXPECT_TRUE(fa.match("abaa"));
+  EXPECT_FALSE(fa.match("a"));
+}
+
+TEST(ParserTest, BAFormatDefaults) {
+  fa::ParseResult result = fa::Parser::parse("a,[p]->[q]\nb,[q]->[p]\n", fa::TextFormat::BA);
+  ASSERT_TRUE(result.valid);
+  EXPECT_TRUE(result.automaton.isStateInitial(0));
+  EXPECT_FALSE(result.automaton.isStateInitial(1));
+  EXPECT_EQ(2u, result.automaton.countFinalStates());
+
+  fa::ParseResult error = fa::Parser::parse("a,[p]->[q]\na,[p]-[q]\n", fa::TextFormat::BA);
+  EXPECT_FALSE(error.valid);
+  EXPECT_EQ(2u, error.line);
+}
+
+TEST(ParserTest, PrintRoundTrip) {
+  fa::Automaton fa = fa::Regex("(a|b)*abb").createAutomaton();
+  fa.addSymbol('z');
+  for (fa::TextFormat format : {fa::TextFormat::Simple, fa::TextFormat::BA}) {
+    std::ostringstream os;
+    fa::Parser::print(os, fa, format);
+    fa::ParseResult result = fa::Parser::parse(os.str(), format);
+    ASSERT_TRUE(result.valid);
+    EXPECT_EQ(fa.countStates(), result.automaton.countStates());
+    EXPECT_EQ(fa.countTransitions(), result.automaton.countTransitions());
+    EXPECT_TRUE(result.automaton.match("babb"));
+    EXPECT_FALSE(result.automaton.match("bab"));
+  }
+  std::ostringstream os;
+  fa::Parser::print(os, fa, fa::TextFormat::Simple);
+  EXPECT_TRUE(fa::Parser::parse(os.str(), fa::TextFormat::Simple).automaton.hasSymbol('z'));
+}
+
+TEST(ParserTest, LargeFile) {
+  const int nb_states = 100000;
+  std::string text = "initial 0\nfinal 0\n";
+  for (int s = 0; s < nb_states; s++) {
+    text += std::to_string(s) + " a " + std::to_string((s + 1) % nb_states) + "\n";
+    text += std::to_string(s) + " b " + std::to_string((s + 7) % nb_states) + "\n";
+  }
+  std::string path = ::testing::TempDir() + "testfa_parser.txt";
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << text;
+  }
+  fa::ParseResult result = fa::Parser::parseFile(path, fa::TextFormat::Simple);
+  std::remove(path.c_str());
+  ASSERT_TRUE(result.valid);
+  EXPECT_EQ(static_cast<std::size_t>(nb_states), result.automaton.countStates());
+  EXPECT_EQ(2u * nb_states, result.automaton.countTransitions());
+  EXPECT_TRUE(result.automaton.isDeterministic());
+  EXPECT_TRUE(result.automaton.isComplete());
+
+  EXPECT_FALSE(fa::Parser::parseFile(path, fa::TextFormat::Simple).valid);
+}
+
+/**
+ * Alphabet
+*/
+TEST(AlphabetTest, InsertEraseContains) {
+  fa::Alphabet alphabet;
+  EXPECT_TRUE(alphabet.empty());
+  EXPECT_TRUE(alphabet.insert('b'));
+  EXPECT_TRUE(alphabet.insert('\xff'));
+  EXPECT_FALSE(alphabet.insert('b'));
+  EXPECT_EQ(2u, alphabet.size());
+  EXPECT_TRUE(alphabet.contains('\xff'));
+  EXPECT_FALSE(alphabet.contains('a'));
+  EXPECT_TRUE(alphabet.erase('b'));
+  EXPECT_FALSE(alphabet.erase('b'));
+  EXPECT_EQ(1u, alphabet.size());
+  alphabet.clear();
+  EXPECT_TRUE(alphabet.empty());
+  EXPECT_EQ(alphabet.begin(), alphabet.end());
+}
+
+TEST(AlphabetTest, SameOrderAsSetOfChar) {
+  std::set<char> expected;
+  fa::Alphabet alphabet;
+  for (int byte = 1; byte < 256; byte += 7) {
+    expected.insert(static_cast<char>(byte));
+    alphabet.insert(static_cast<char>(byte));
+  }
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), alphabet.begin(), alphabet.end()));
+}
+
+TEST(AlphabetTest, EveryByte) {
+  fa::Automaton fa;
+  for (int byte = 0; byte < 256; byte++) {
+    EXPECT_EQ(byte != 0, fa.addSymbol(static_cast<char>(byte)));
+  }
+  EXPECT_EQ(255u, fa.countSymbols());
+  EXPECT_TRUE(fa.hasSymbol('\x80'));
+  EXPECT_FALSE(fa.hasSymbol(fa::Epsilon));
+}
+
+TEST(AlphabetTest, RawBytes) {
+  // Un en-tête binaire : 0x00 interdit, puis un octet quelconque, puis "\r\n"
+  fa::Automaton fa = fa::Regex("\\xca\\xfe[\\x01-\\xff]\r\n").createAutomaton();
+  ASSERT_TRUE(fa.isValid());
+  EXPECT_TRUE(fa.match("\xca\xfe\x80\r\n"));
+  EXPECT_TRUE(fa.match("\xca\xfe \r\n"));
+  EXPECT_FALSE(fa.match("\xca\xfe\x80\n"));
+  EXPECT_EQ(255u, fa.countSymbols());
+
+  fa::Automaton minimal = fa::Automaton::createMinimalMoore(fa);
+  EXPECT_TRUE(minimal.match("\xca\xfe\xff\r\n"));
+  EXPECT_FALSE(minimal.match("\xca\xfe\r\n"));
+  EXPECT_TRUE(fa::Automaton::createMinimalBrzozowski(fa).match("\xca\xfe\x01\r\n"));
+  EXPECT_TRUE(fa.freeze().match("\xca\xfe\x7f\r\n"));
+}
+
+TEST(AlphabetTest, Utf8) {
+  fa::Regex regex("caf(é|e)+ ?!");
+  ASSERT_TRUE(regex.isValid());
+  fa::Automaton fa = fa::Automaton::createDeterministic(regex.createAutomaton());
+  EXPECT_TRUE(fa.match("café!"));
+  EXPECT_TRUE(fa.match("cafeéé !"));
+  EXPECT_FALSE(fa.match("caf!"));
+  EXPECT_FALSE(fa.match("caf\xc3!"));
+  EXPECT_TRUE(fa.hasSymbol('\xc3'));
+  EXPECT_TRUE(fa.hasSymbol(' '));
+}
+
+TEST(AlphabetTest, ParserEscapes) {
+  fa::Automaton fa = fa::Regex("a\\x01[ ,\\xff]").createAutomaton();
+  for (fa::TextFormat format : {fa::TextFormat::Simple, fa::TextFormat::BA}) {
+    std::ostringstream os;
+    fa::Parser::print(os, fa, format);
+    fa::ParseResult result = fa::Parser::parse(os.str(), format);
+    ASSERT_TRUE(result.valid);
+    EXPECT_TRUE(result.automaton.match("a\x01 "));
+    EXPECT_TRUE(result.automaton.match("a\x01,"));
+    EXPECT_TRUE(result.automaton.match("a\x01\xff"));
+    EXPECT_FALSE(result.automaton.match("a\x01" "b"));
+  }
+  EXPECT_FALSE(fa::Parser::parse("0 \\x00 1\n", fa::TextFormat::Simple).valid);
+}
+
+/**
+ * RangeAutomaton
+*/
+TEST(RangeAutomatonTest, AddTransition) {
+  fa::RangeAutomaton fa;
+  EXPECT_TRUE(fa.addState(0));
+  EXPECT_TRUE(fa.addState(1));
+  EXPECT_FALSE(fa.addState(-1));
+  fa.setStateInitial(0);
+  fa.setStateFinal(1);
+  EXPECT_TRUE(fa.addTransition(0, 'a', 'z', 1));
+  EXPECT_FALSE(fa.addTransition(0, 'a', 'z', 1));
+  EXPECT_FALSE(fa.addTransition(0, 'z', 'a', 1));
+  EXPECT_FALSE(fa.addTransition(0, fa::Epsilon, 'a', 1));
+  EXPECT_FALSE(fa.addTransition(0, 'a', 'b', 2));
+  EXPECT_TRUE(fa.addTransition(0, '\x80', '\xff', 0));
+  EXPECT_TRUE(fa.hasTransition(0, 'a', 'z', 1));
+  EXPECT_EQ(2u, fa.countTransitions());
+  EXPECT_EQ(0, fa.getTransitions()[0].from);
+  EXPECT_EQ('a', fa.getTransitions()[0].low);
+  EXPECT_TRUE(fa.match("\xff\x80q"));
+  EXPECT_FALSE(fa.match("A"));
+  EXPECT_FALSE(fa.match(""));
+}
+
+TEST(RangeAutomatonTest, DeterministicComplete) {
+  fa::RangeAutomaton fa;
+  fa.addState(0);
+  fa.addState(1);
+  fa.setStateInitial(0);
+  fa.addTransition(0, 'a', 'm', 1);
+  fa.addTransition(0, 'n', 'z', 1);
+  fa.addTransition(0, 'c', 'c', 1);
+  EXPECT_TRUE(fa.isDeterministic());
+  fa.addTransition(0, 'k', 'p', 0);
+  EXPECT_FALSE(fa.isDeterministic());
+  EXPECT_FALSE(fa.isComplete());
+
+  fa::RangeAutomaton complete = fa::RangeAutomaton::createComplete(fa);
+  EXPECT_TRUE(complete.isComplete());
+  EXPECT_EQ(3u, complete.countStates());
+  // [\x01-`], [{-\xff] pour 0, [\x01-\xff] pour 1 et pour le puits
+  EXPECT_EQ(fa.countTransitions() + 4u, complete.countTransitions());
+  EXPECT_TRUE(complete.hasTransition(2, fa::MinRangeSymbol, fa::MaxRangeSymbol, 2));
+}
+
+TEST(RangeAutomatonTest, FromAndToAutomaton) {
+  fa::Automaton automaton = fa::Regex("[a-z_][a-z0-9_]*").createAutomaton();
+  fa::RangeAutomaton fa = fa::RangeAutomaton::fromAutomaton(automaton);
+  EXPECT_EQ(automaton.countStates(), fa.countStates());
+  EXPECT_LT(fa.countTransitions(), 12u);
+  EXPECT_GT(automaton.countTransitions(), 100u);
+
+  fa::Automaton back = fa.toAutomaton();
+  EXPECT_EQ(automaton.countTransitions(), back.countTransitions());
+  EXPECT_EQ(automaton.countSymbols(), back.countSymbols());
+  for (std::string word : {"", "x", "_a9", "9a", "ab_c", "aB"}) {
+    EXPECT_EQ(automaton.match(word), fa.match(word)) << word;
+    EXPECT_EQ(automaton.match(word), back.match(word)) << word;
+  }
+}
+
+TEST(RangeAutomatonTest, CreateDeterministic) {
+  // Les intervalles se chevauchent : [a-m] et [h-z]
+  fa::RangeAutomaton fa;
+  for (int state = 0; state < 3; state++) {
+    fa.addState(state);
+  }
+  fa.setStateInitial(0);
+  fa.setStateFinal(2);
+  fa.addTransition(0, 'a', 'm', 0);
+  fa.addTransition(0, 'h', 'z', 1);
+  fa.addTransition(1, '0', '9', 2);
+
+  fa::RangeAutomaton deterministic = fa::RangeAutomaton::createDeterministic(fa);
+  EXPECT_TRUE(deterministic.isDeterministic());
+  EXPECT_TRUE(deterministic.isStateInitial(0));
+  // {0}, {0, 1} par [h-m], {1} par [n-z] et {2}
+  EXPECT_EQ(4u, deterministic.countStates());
+  EXPECT_TRUE(deterministic.hasTransition(0, 'a', 'g', 0));
+  EXPECT_TRUE(deterministic.hasTransition(0, 'h', 'm', 1));
+  EXPECT_TRUE(deterministic.hasTransition(0, 'n', 'z', 2));
+  for (std::string word : {"a", "h5", "aah5", "az9", "ab5", "z", "hh0", "n0", ""}) {
+    EXPECT_EQ(fa.match(word), deterministic.match(word)) << word;
+  }
+}
+
+TEST(RangeAutomatonTest, CreateProduct) {
+  fa::RangeAutomaton lhs = fa::RangeAutomaton::fromAutomaton(
+      fa::Regex("[a-z]+").createAutomaton());
+  fa::RangeAutomaton rhs = fa::RangeAutomaton::fromAutomaton(
+      fa::Regex("[\\x01-\\xff]*[m-q]").createAutomaton());
+  fa::RangeAutomaton product = fa::RangeAutomaton::createProduct(lhs, rhs);
+  EXPECT_TRUE(product.match("abcn"));
+  EXPECT_TRUE(product.match("p"));
+  EXPECT_FALSE(product.match("abc"));
+  EXPECT_FALSE(product.match("ABn"));
+  EXPECT_FALSE(product.match(""));
+}
+
+TEST(RangeAutomatonTest, CreateProductManyInitialStates) {
+  fa::RangeAutomaton lhs;
+  for (int state = 0; state < 3; state++) {
+    lhs.addState(state);
+  }
+  lhs.setStateInitial(0);
+  lhs.setStateInitial(1);
+  lhs.setStateFinal(2);
+  lhs.addTransition(0, 'a', 'a', 2);
+  lhs.addTransition(1, 'b', 'b', 2);
+  fa::RangeAutomaton rhs;
+  for (int state = 10; state < 13; state++) {
+    rhs.addState(state);
+  }
+  rhs.setStateInitial(10);
+  rhs.setStateInitial(11);
+  rhs.setStateFinal(12);
+  rhs.addTransition(10, 'a', 'b', 12);
+  rhs.addTransition(11, 'c', 'c', 12);
+
+  fa::RangeAutomaton product = fa::RangeAutomaton::createProduct(lhs, rhs);
+  // Les 4 couples d'états initiaux, puis (2, 12)
+  EXPECT_EQ(5u, product.countStates());
+  for (int state = 0; state < 4; state++) {
+    EXPECT_TRUE(product.isStateInitial(state));
+  }
+  EXPECT_TRUE(product.match("a"));
+  EXPECT_TRUE(product.match("b"));
+  EXPECT_FALSE(product.match("c"));
+  EXPECT_FALSE(product.match(""));
+}
+
+TEST(RangeAutomatonTest, CreateMinimal) {
+  const char* expressions[] = {"(a|b)*abb", "[a-z_][a-z0-9_]*", "[\\x01-\\xff]*[\\x80-\\xbf]", "(ab|[a-c]b)+c?"};
+  for (const char* expression : expressions) {
+    fa::Automaton automaton = fa::Regex(expression).createAutomaton();
+    fa::RangeAutomaton minimal = fa::RangeAutomaton::createMinimal(
+        fa::RangeAutomaton::fromAutomaton(automaton));
+    EXPECT_TRUE(minimal.isDeterministic()) << expression;
+    EXPECT_TRUE(minimal.isComplete()) << expression;
+    EXPECT_TRUE(minimal.isStateInitial(0)) << expression;
+
+    // Même nombre d'états que la minimisation sur l'alphabet de tous les octets
+    fa::Automaton bytes = automaton;
+    for (int byte = 1; byte < 256; byte++) {
+      bytes.addSymbol(static_cast<char>(byte));
+    }
+    EXPECT_EQ(fa::Automaton::createMinimalMoore(bytes).countStates(), minimal.countStates())
+        << expression;
+
+    for (std::string word : {"", "a", "abb", "babb", "x_1", "9", "\x80", "a\xbf", "abc", "bbbbc"}) {
+      EXPECT_EQ(automaton.match(word), minimal.match(word)) << expression << " " << word;
+    }
+  }
+}
+
+TEST(RangeAutomatonTest, IntervalsStayCompact) {
+  // Deux classes couvrant tout l'alphabet : le coût ne dépend pas de ses 255 symboles
+  fa::RangeAutomaton fa = fa::RangeAutomaton::fromAutomaton(
+      fa::Regex("[\\x01-\\x7f]*[\\x80-\\xff][\\x01-\\xff]*").createAutomaton());
+  fa::RangeAutomaton minimal = fa::RangeAutomaton::createMinimal(fa);
+  EXPECT_EQ(2u, minimal.countStates());
+  EXPECT_EQ(3u, minimal.countTransitions());
+  EXPECT_TRUE(minimal.match("abc\xe9"));
+  EXPECT_FALSE(minimal.match("abc"));
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();